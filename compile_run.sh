@@ -1,11 +1,11 @@
 #! /bin/bash
 
 # compile the source code
-gcc -Wall -g scee.c -o scee
+gcc -Wall -g -pthread scee.c -o scee
 
 # compile auxiliary programs
-gcc -Wall -g integers.c -o integers
-gcc -Wall -g times.c -o times
+gcc -Wall -g integers.c scee_stats.c -o integers
+gcc -Wall -g times.c scee_stats.c -o times
 
 # run the application
 ./scee
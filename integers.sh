@@ -1,7 +1,7 @@
 #! /bin/bash
 
 # compile the source code
-gcc -Wall -g integers.c -o integers
+gcc -Wall -g integers.c scee_stats.c -o integers
 
 # run the application
 ./integers
@@ -11,23 +11,60 @@
 // stop, stop the execution of a running spawned process given its PID.
 // cont, resume the execution of a stopped spawned process given its PID.
 // list, print a list of the running spawned processes.
-// info, request information about a spawned process given it PID.
+// info, print information about a spawned process given its PID.
+// top, print the resource usage of the spawned processes.
+// tail, print the latest output of a process spawned with exec --capture.
+// stats, print the latency percentiles of the commands and system calls.
+// sched, time-slice the spawned processes, letting at most K run at a time.
+// limit, cap the CPU usage of a spawned process at a percentage of a CPU.
 // quit, terminate the application.
 //
 // The commands can be requested using just the first letter of their name.
+//
+// When the commands are read from a script, given with the option -b, or
+// from a pipe, scee runs in batch mode, without clearing the screen and
+// printing the interface.
+//
+// With the option --daemon SOCKET, scee runs as a daemon that receives
+// the commands of any number of clients, such as scee_client, through a Unix
+// domain socket.
+//
 // Once compiled, the integers and times programs can be executed via their
 // i and t symbolic links, respectively.
 ////////////////////////////////////////////////////////////////////////////////
 
 // #include directives
 ////////////////////////////////////////////////////////////////////////////////
+#define _GNU_SOURCE  // pipe2, cpu_set_t
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
 #include <signal.h>
 #include <time.h>
 #include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/signalfd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <linux/mempolicy.h>
+#include "scee_stats.h"
 ////////////////////////////////////////////////////////////////////////////////
 
 // #define directives
@@ -37,6 +74,10 @@
 #define MAX_STATUS_LENGTH 16
 #define MAX_TASK_LENGTH 4
 #define MAX_PATH_LENGTH 512
+#define MAX_PROC_FILE_LENGTH 1024
+#define MAX_TOKENS (MAX_INPUT_LENGTH / 2 + 1)
+        // Tokens are separated by at least one character, so an input can't
+        // have more.
 
 // http://stackoverflow.com/a/3219471
 // http://en.wikipedia.org/wiki/ANSI_escape_code
@@ -44,34 +85,618 @@
 #define ANSI_BOLD "\x1b[1m"
 #define ANSI_RESET "\x1b[0m"
 
-#define SLEEP_SECONDS 0
-#define SLEEP_NANOSECONDS 100000000
-        // 100,000,000 nanoseconds, equal to 0.1 seconds.
+#define STRINGIFY(x) STRINGIFY_VALUE(x)
+#define STRINGIFY_VALUE(x) #x
+        // STRINGIFY expands its argument before turning it into a string.
+
+#define INDEX_INITIAL_CAPACITY 16
+        // The capacity must be a power of 2. The index grows when it is half
+        // full, which keeps the probe sequences short.
+
+#define BUFFER_INITIAL_CAPACITY 4096
+
+#define POOL_CHUNK_SIZE 256
+        // The number of nodes allocated at once by pool_alloc.
+
+#define PATH_TABLE_SIZE 64
+        // The number of buckets of the interned paths table. The paths are
+        // few and shared by many processes, so the table doesn't grow.
+
+#define MAX_BULK_SPAWNS 65536
+        // The maximum number of processes spawned by a single exec -n.
+
+#define MAX_SAMPLED_PROCESSES 32768
+        // The number of slots of the sampler. They are allocated at once, so
+        // that they never move while the sampler thread reads them.
+
+#define SAMPLE_INTERVAL_NANOSECONDS 1000000000L
+        // 1,000,000,000 nanoseconds, equal to 1 second.
+#define RSS_SAMPLE_TICKS 4
+        // The resident set size changes slowly, so statm is reread only every
+        // RSS_SAMPLE_TICKS samples, halving the cost of sampling.
+
+#define CAPTURE_BUFFER_SIZE 8192
+        // The size of the ring buffer that keeps the latest output of
+        // a process spawned with exec --capture. It must be a power of 2.
+#define MAX_CAPTURE_EVENTS 64
+        // The number of events handled per epoll_wait by the capture thread.
+#define TAIL_DEFAULT_LINES 10
+
+#define LOG_PIPE_SIZE (1024 * 1024)
+        // The size requested for the output pipes of the logged processes,
+        // and the most bytes moved by a single splice.
+#define LOG_ROTATE_BYTES (64L * 1024 * 1024)
+        // The size at which a log file is rotated.
+#define LOG_ROTATIONS 3
+        // The number of rotated log files kept, named <log>.1 to <log>.3.
+
+#define INFO_TIMEOUT_MILLISECONDS 200
+        // The time the processes are given to reply to SIGUSR1 by info.
+
+#define QUIT_TIMEOUT_MILLISECONDS 1000
+        // The time the processes are given to terminate after SIGTERM, when
+        // quitting, before they are killed with SIGKILL.
+
+#define BENCH_PROGRAM "./integers"
+#define BENCH_PROGRAM_ARGUMENT "32"
+        // The program spawned by bench_operations, which outputs little.
+#define BENCH_SAMPLES 200
+        // The number of samples of exec, stop, cont, and kill per size.
+#define BENCH_LIST_SAMPLES 20
+        // The number of samples of list per size. It must not be greater than
+        // BENCH_SAMPLES.
+#define BENCH_MAX_SIZES 16
+
+#define HISTOGRAM_SUB_BITS 4
+        // Each power of 2 of a histogram is split into 2^HISTOGRAM_SUB_BITS
+        // linear buckets, which bounds the error of a percentile to 6.25%.
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS) << HISTOGRAM_SUB_BITS)
+        // Enough buckets for any non-negative long, up to 2^63 - 1.
+
+#define CLIENT_INPUT_SIZE 65536
+        // The size of the buffer of the commands received from a client.
+#define CLIENT_OUTPUT_LIMIT (1024 * 1024)
+        // The size of the unsent responses of a client above which its
+        // commands aren't read any more, until the responses are sent.
+#define MAX_BATCH_COMMANDS 4096
+        // The most commands of a client executed before their output is
+        // collected.
+#define MAX_SERVER_EVENTS 64
+        // The number of events handled per epoll_wait by the daemon.
+#define SERVER_BACKLOG 128
+
+#define SCHED_DEFAULT_QUANTUM_MILLISECONDS 100
+#define SCHED_MAX_WEIGHT 100
+
+#define THROTTLE_INTERVAL_NANOSECONDS 10000000L
+#define THROTTLE_PERIOD_NANOSECONDS 100000000L
+#define MAX_CPU_LIMIT 6400
+
+#define MAX_NUMA_NODES 64
+#define MAX_PLACEMENT_LENGTH 64
+
+#define CGROUP_CPU_PERIOD_MICROSECONDS 100000
+#define MAX_JOB_NAME_LENGTH 40
+
+#define EXEC_FAILURE_STATUS 127
+        // The exit status of a child process that failed to execute a file,
+        // the same as the one used by the shell.
 ////////////////////////////////////////////////////////////////////////////////
 
 // custom data types
 ////////////////////////////////////////////////////////////////////////////////
+struct usage_s {
+    // This struct holds the resource usage of a process. It is sampled from
+    // /proc while the process is running and taken from its rusage once it
+    // has been reaped.
+    long start_time;  // The time the process was spawned, in nanoseconds.
+    long end_time;  // The time the process was reaped, or 0.
+    long sample_time;  // The time of the last sample, or 0.
+    long cpu_time;  // The user and system CPU time, in nanoseconds.
+    long rss;  // The resident set size in KiB, the maximum once reaped.
+    long context_switches;  // The number of context switches.
+    double cpu_percent;  // The CPU usage between the last two samples.
+};
+typedef struct usage_s usage_t;
+
+struct job_s {
+    // This struct is a job, the processes spawned by one exec command, in
+    // a cgroup of its own. Jobs only exist when cgroups are available and
+    // a limit of the cgroup is given.
+    char name[MAX_JOB_NAME_LENGTH + 1];  // The directory of the cgroup.
+    int dir_fd;  // The directory of the cgroup.
+    int procs_fd;  // Its cgroup.procs file, where processes are moved.
+    int num_processes;  // The processes of the job in the list.
+    int num_alive;  // Those of them that haven't exited.
+    int num_selected;  // Those of them selected, used by jobs_freeze.
+    int frozen;  // Boolean indicator that cgroup.freeze is set.
+    struct job_s *next;  // The next job not removed yet.
+};
+typedef struct job_s job_t;
+
 struct process_s {
     // This struct is a node of a doubly linked list. Its data is information
     // about a process.
     int pid;  // PID
-    char *path;  // Path to the executable file.
+    int pgid;  // The process group of the process.
+    char *path;  // Path to the executable file, interned with path_intern.
     int stopped;  // Boolean indicator that the process has been stopped.
+    int exited;  // Boolean indicator that the process has exited.
+    int exit_status;  // The status reported by waitpid, once it has exited.
+    usage_t usage;  // The resource usage of the process.
+    int sample_slot;  // The slot of the process in the sampler, or -1.
+    int sched_slot;  // The entry of the process in the scheduler, or -1.
+    int cpu_limit;  // The share of a CPU allowed, in percent, or 0.
+    int throttle_slot;  // The entry of the process in the throttler, or -1.
+    char *placement;  // Where exec placed the process, interned, or NULL.
+    job_t *job;  // The job of the process, or NULL without cgroups.
+    struct capture_s *capture;  // The captured output, or NULL.
+    scee_stats_t *stats;  // The statistics page shared with the process.
     struct process_s *next;  // The next node of the list.
     struct process_s *previous;  // The previous node of the list.
+    struct pid_index_s *index;  // The PID index of the list.
 };
 typedef struct process_s process_t;
+
+enum spread_e {
+    // This enum is how exec spreads the processes over the machine.
+    SPREAD_NONE,
+    SPREAD_CPU,  // One CPU per process, round-robin.
+    SPREAD_NODE  // The CPUs of one NUMA node per process, round-robin.
+};
+
+struct exec_options_s {
+    // This struct is the options of exec, shared by the processes it spawns.
+    int capture;  // Boolean indicator that the output is captured.
+    char *log_path;  // The log file of the output, or NULL.
+    int cpu_limit;  // The share of a CPU allowed, in percent, or 0.
+    int has_cpus;  // Boolean indicator that cpus restricts the processes.
+    cpu_set_t cpus;  // The CPUs the processes may run on.
+    enum spread_e spread;
+    int membind;  // Boolean indicator that memory comes from local nodes.
+    long rlimit_as;  // The address space of every process, in bytes, or 0.
+    long rlimit_cpu;  // The CPU time of every process, in seconds, or 0.
+    long rlimit_nofile;  // The open files of every process, or 0.
+    long memory_max;  // The memory of the whole job, in bytes, or 0.
+    int cpu_max;  // The CPU share of the whole job, in percent, or 0.
+    job_t *job;  // The job of the processes, or NULL.
+};
+typedef struct exec_options_s exec_options_t;
+
+struct pid_slot_s {
+    // This struct is a slot of an open addressing hash table. The PID is
+    // stored next to the node pointer so that probing doesn't have to
+    // dereference the nodes.
+    int pid;  // PID, or 0 if the slot is empty.
+    process_t *process;  // The node of the process with this PID.
+};
+typedef struct pid_slot_s pid_slot_t;
+
+struct pid_index_s {
+    // This struct is an open addressing hash table with linear probing that
+    // maps PIDs to the nodes of a list. The list keeps the order of
+    // the processes, the index provides constant time lookups.
+    pid_slot_t *slots;  // The slots of the table.
+    int capacity;  // The number of slots, always a power of 2.
+    int count;  // The number of occupied slots.
+    int length;  // The number of nodes of the list, more than count while
+            // an exited process has a node besides the one of the new
+            // process its PID was reused for.
+};
+typedef struct pid_index_s pid_index_t;
+
+struct command_s {
+    // This struct holds a command read by read_command. It is reused for
+    // every command, so reading and parsing don't allocate any memory.
+    char line[MAX_INPUT_LENGTH + 2];  // The input, split in place.
+    char *tokens[MAX_TOKENS + 1];  // The tokens of the input, NULL terminated.
+    int num_tokens;  // The number of tokens.
+};
+typedef struct command_s command_t;
+
+enum operation_e {
+    // The operations whose latency is recorded in histograms, the commands
+    // followed by the system calls made by them.
+    OPERATION_EXEC,
+    OPERATION_KILL,
+    OPERATION_STOP,
+    OPERATION_CONT,
+    OPERATION_LIST,
+    OPERATION_INFO,
+    OPERATION_TOP,
+    OPERATION_TAIL,
+    OPERATION_STATS,
+    OPERATION_SCHED,
+    OPERATION_LIMIT,
+    OPERATION_QUIT,
+    OPERATION_FORK,  // fork in exec
+    OPERATION_EXEC_WAIT,  // the wait for execv to succeed or fail in exec
+    OPERATION_POSIX_SPAWN,  // posix_spawn in exec -n
+    OPERATION_SIGNAL,  // kill, sending any signal
+    OPERATION_WAIT4,  // wait4 collecting an exited process
+    NUM_OPERATIONS
+};
+
+struct task_s {
+    // This struct is an entry of the table of the commands of scee.
+    const char *name;  // The name of the command.
+    const char *abbreviation;  // The abbreviation of the name.
+    int (*function)(process_t *processes, char *arguments[]);
+            // The function that executes the command.
+    enum operation_e operation;  // The histogram of the command.
+};
+typedef struct task_s task_t;
+
+struct selection_s {
+    // This struct holds the nodes of the processes selected by
+    // process_select for a bulk command.
+    process_t **nodes;  // The selected nodes.
+    int *results;  // The errno values of signalling the nodes, or 0.
+    int num_nodes;  // The number of selected nodes.
+    int capacity;  // The number of nodes that fit in nodes and results.
+    int pgid;  // The process group selected, or 0.
+};
+typedef struct selection_s selection_t;
+
+struct sample_s {
+    // This struct is a slot of the sampler, describing a process sampled by
+    // the sampler thread. The main thread assigns a PID to the slot, and
+    // the sampler thread keeps the /proc files of that PID open and publishes
+    // its samples under the seqlock sequence. The generation tells apart
+    // the processes successively given the slot, even with the same PID.
+    atomic_int pid;  // The PID to sample, 0 if the slot is free.
+    atomic_uint generation;  // Incremented whenever the slot is assigned.
+    atomic_uint sequence;  // Odd while a sample is being published.
+
+    // The published sample.
+    unsigned int sampled_generation;  // The generation it belongs to.
+    long sample_time;
+    long cpu_time;
+    long rss;
+    long context_switches;
+    double cpu_percent;
+
+    // Used only by the sampler thread.
+    int open_pid;  // The PID of the open files, or 0.
+    unsigned int open_generation;  // The generation of the open files.
+    int schedstat_fd;  // /proc/<pid>/schedstat, or -1.
+    int statm_fd;  // /proc/<pid>/statm, or -1.
+};
+typedef struct sample_s sample_t;
+
+struct sampler_s {
+    // This struct is the state of the sampler, a thread that samples
+    // the resource usage of the running processes every
+    // SAMPLE_INTERVAL_NANOSECONDS.
+    sample_t *slots;  // MAX_SAMPLED_PROCESSES slots.
+    atomic_int num_slots;  // The number of slots ever used.
+    int *free_slots;  // The indices of the free slots, used as a stack.
+    int num_free;  // The number of free slots.
+    int max_open_files;  // The most files the thread may keep open.
+    int num_open_files;  // The number of files open, used by the thread.
+    int running;  // Boolean indicator that the thread has been started.
+    pthread_t thread;
+};
+typedef struct sampler_s sampler_t;
+
+struct capture_s {
+    // This struct describes where the output of a process, written to its
+    // standard output and error, goes: a ring buffer holding the latest
+    // CAPTURE_BUFFER_SIZE bytes, a log file, or both. It is filled by
+    // the capture thread and read by the tail and list commands, both under
+    // the lock of the capturer.
+    unsigned long num_written;  // The number of bytes ever written.
+    int fd;  // The read end of the output pipe, or -1 once closed.
+    int capturing;  // Boolean indicator that data holds a ring buffer.
+    int log_fd;  // The log file, or -1.
+    char *log_path;  // The path to the log file, or NULL.
+    long log_size;  // The size of the current log file.
+    atomic_ulong num_logged;  // The number of bytes ever logged.
+
+    // Used only by the main thread, to compute the logging rate.
+    unsigned long rate_bytes;  // num_logged when the rate was computed.
+    long rate_time;  // The time the rate was computed.
+    double log_rate;  // The bytes logged per second.
+
+    char data[];  // CAPTURE_BUFFER_SIZE bytes, if capturing.
+};
+typedef struct capture_s capture_t;
+
+struct capturer_s {
+    // This struct is the state of the capturer, a thread that drains
+    // the output pipes of the processes spawned with exec --capture into
+    // their ring buffers, waiting on all of them with epoll.
+    int epoll_fd;
+    pthread_mutex_t lock;  // Protects captures and the ring buffers.
+    capture_t **captures;  // The ring buffers, indexed by pipe descriptor.
+    int num_captures;  // The number of entries of captures.
+    int scratch_pipe[2];  // Holds the output both captured and logged.
+    int running;  // Boolean indicator that the thread has been started.
+    pthread_t thread;
+};
+typedef struct capturer_s capturer_t;
+
+enum info_source_e {
+    // The ways info gets the information of a process.
+    INFO_SHARED,  // read from its statistics page
+    INFO_SIGNAL,  // received in reply to SIGUSR1
+    INFO_PENDING,  // SIGUSR1 sent, no reply yet
+    INFO_STOPPED,  // not requested, the process is stopped
+    INFO_UNAVAILABLE  // the process doesn't report information
+};
+
+struct info_request_s {
+    // This struct holds the information of a process requested by info.
+    int pid;  // PID
+    const char *path;  // Path to the executable file.
+    enum info_source_e source;  // Where the information comes from.
+    long counter;  // The number of outputs so far.
+    long delay;  // The number of seconds between successive outputs.
+    long latency;  // The time taken to get the information, in nanoseconds.
+    long send_time;  // When SIGUSR1 was sent, CLOCK_MONOTONIC in ns.
+};
+typedef struct info_request_s info_request_t;
+
+struct buffer_s {
+    // This struct is a growable output buffer. Output is accumulated in it and
+    // written with a single system call.
+    char *data;
+    size_t length;  // The number of bytes used.
+    size_t capacity;  // The number of bytes allocated.
+};
+typedef struct buffer_s buffer_t;
+
+struct pool_chunk_s {
+    // This struct is a block of nodes allocated at once by pool_alloc.
+    struct pool_chunk_s *next;  // The previously allocated chunk.
+    process_t nodes[POOL_CHUNK_SIZE];
+};
+typedef struct pool_chunk_s pool_chunk_t;
+
+struct pool_s {
+    // This struct is a slab allocator of list nodes. Freed nodes are kept in
+    // a free list, linked through their next pointers, and reused.
+    pool_chunk_t *chunks;  // The allocated chunks.
+    process_t *free_nodes;  // The free list.
+    int num_chunks;  // The number of allocated chunks.
+    int num_used;  // The number of nodes in use.
+};
+typedef struct pool_s pool_t;
+
+struct path_s {
+    // This struct is an interned path, shared by all the nodes of processes
+    // of the same executable file. It is a node of a singly linked list of
+    // a bucket of the interned paths table.
+    struct path_s *next;  // The next path in the bucket.
+    int refcount;  // The number of nodes using the path.
+    int length;  // The length of the path.
+    char string[];  // The path itself.
+};
+typedef struct path_s path_t;
+
+struct histogram_s {
+    // This struct is a log-linear histogram of latencies in nanoseconds.
+    // Values below 2^HISTOGRAM_SUB_BITS have a bucket each, larger ones share
+    // a bucket with the values of the same power of 2 and the same
+    // HISTOGRAM_SUB_BITS most significant bits.
+    long count;  // The number of recorded values.
+    long max;  // The largest recorded value.
+    long buckets[HISTOGRAM_BUCKETS];
+};
+typedef struct histogram_s histogram_t;
+
+struct sched_entry_s {
+    // This struct is a process time-sliced by the scheduler.
+    int pid;  // PID
+    int weight;  // The share of CPU time relative to the other processes.
+    int active;  // Boolean indicator that the process is let run.
+    long virtual_time;  // The time run divided by the weight, in nanoseconds.
+    long run_time;  // The time the process was let run, in nanoseconds.
+    long num_slices;  // The number of quanta the process was let run.
+    process_t *node;  // The node of the process, used by the main thread.
+};
+typedef struct sched_entry_s sched_entry_t;
+
+struct scheduler_s {
+    // This struct is the state of the scheduler, a thread that lets at most
+    // max_running of the processes run at a time, stopping and resuming them
+    // with SIGSTOP and SIGCONT every quantum, as signalled by a timerfd.
+    // The processes with the least run time per weight run next.
+    pthread_mutex_t lock;  // Protects the fields below thread.
+    int timer_fd;
+    int started;  // Boolean indicator that the thread has been started.
+    pthread_t thread;
+    int enabled;  // Boolean indicator that the processes are time-sliced.
+    int max_running;  // The most processes let run at a time.
+    long quantum;  // The time slice, in nanoseconds.
+    sched_entry_t *entries;  // The scheduled processes, in no order.
+    sched_entry_t **order;  // The entries sorted by the thread every quantum.
+    int num_entries;
+    int capacity;  // The number of entries that fit in entries and order.
+    long min_virtual_time;  // The least virtual time at the last quantum.
+    long enabled_time;  // The time the scheduler was enabled.
+    long last_tick;  // The time of the last quantum.
+    long num_ticks;
+    long num_signals;  // The number of SIGSTOP and SIGCONT sent.
+    long overhead;  // The time spent switching processes, in nanoseconds.
+    histogram_t tick_histogram;  // The time spent per quantum.
+};
+typedef struct scheduler_s scheduler_t;
+
+struct cgroups_s {
+    // This struct is the cgroup v2 subtree delegated to scee, in which a cgroup
+    // is created for every job.
+    int started;  // Boolean indicator that cgroup_start has been called.
+    int base_fd;  // The cgroup scee was started in, or -1.
+    int root_fd;  // The cgroup of the jobs, or -1 if cgroups are unavailable.
+    char root_name[MAX_JOB_NAME_LENGTH + 1];  // Its directory in base_fd.
+    int in_leaf;  // Boolean indicator that scee moved itself into a leaf.
+    int memory_enabled;  // Boolean indicator that scee enabled memory.
+    int cpu_enabled;  // Boolean indicator that scee enabled cpu.
+    int num_created;  // The number of jobs created, to name them.
+    job_t *jobs;  // The jobs whose cgroups haven't been removed yet.
+};
+typedef struct cgroups_s cgroups_t;
+
+struct topology_s {
+    // This struct is the CPUs and NUMA nodes of the machine, read from sysfs
+    // the first time a process is placed.
+    int loaded;  // Boolean indicator that the topology has been read.
+    cpu_set_t cpus;  // The CPUs scee may run on, as inherited.
+    int num_nodes;
+    int node_ids[MAX_NUMA_NODES];  // The node numbers, which may be sparse.
+    cpu_set_t node_cpus[MAX_NUMA_NODES];  // The CPUs of every node.
+};
+typedef struct topology_s topology_t;
+
+struct throttle_entry_s {
+    // This struct is a process whose CPU usage is capped by the throttler.
+    int pid;  // PID
+    int cpu_limit;  // The share of a CPU allowed, in percent.
+    int active;  // Boolean indicator that the process is let run.
+    int schedstat_fd;  // The /proc/<pid>/schedstat file of the process.
+    long cpu_time;  // The CPU time of the process at the last tick.
+    long credit;  // The CPU time the process may still use, in nanoseconds.
+    long start_cpu_time;  // The CPU time of the process when capped.
+    long start_time;  // The time the process was capped.
+    long num_stops;  // The number of times the process was stopped.
+    process_t *node;  // The node of the process, used by the main thread.
+};
+typedef struct throttle_entry_s throttle_entry_t;
+
+struct throttler_s {
+    // This struct is the state of the throttler, a thread that keeps every
+    // capped process near its share of a CPU. Every
+    // THROTTLE_INTERVAL_NANOSECONDS, as signalled by a timerfd, it credits
+    // each process with its share of the elapsed time, debits the CPU time
+    // it used, and stops it with SIGSTOP once the credit runs out, resuming
+    // it with SIGCONT once it is positive again.
+    pthread_mutex_t lock;  // Protects the fields below thread.
+    int timer_fd;
+    int started;  // Boolean indicator that the thread has been started.
+    pthread_t thread;
+    throttle_entry_t *entries;  // The capped processes, in no order.
+    int num_entries;
+    int capacity;  // The number of entries that fit in entries.
+    long last_tick;  // The time of the last tick.
+    long num_ticks;
+    long num_signals;  // The number of SIGSTOP and SIGCONT sent.
+    histogram_t tick_histogram;  // The time spent per tick.
+};
+typedef struct throttler_s throttler_t;
+
+struct client_s {
+    // This struct is a connection of a client to scee in daemon mode.
+    // Commands are read into input and their responses accumulated in output,
+    // which is sent once all the commands read at once have been executed.
+    int fd;
+    int discarding;  // Boolean indicator that a too long line is skipped.
+    int closing;  // Boolean indicator that the client sent all commands.
+    unsigned int events;  // The events the socket is polled for.
+    size_t input_length;  // The number of bytes in input.
+    size_t output_sent;  // The number of bytes of output already sent.
+    int deferred;  // Boolean indicator that a command waits to complete.
+    buffer_t deferred_output;  // What the waiting command printed so far.
+    buffer_t output;
+    char input[CLIENT_INPUT_SIZE];
+};
+typedef struct client_s client_t;
+
+struct info_wait_s {
+    // This struct is an info command of a client in daemon mode waiting for
+    // the replies to SIGUSR1, which the server loop collects through info_fd.
+    client_t *client;  // NULL if the client has disconnected.
+    info_request_t *requests;  // Sorted by PID, their paths interned.
+    int num_requests;
+    int num_pending;  // The number of requests waiting for a reply.
+    int all;  // Boolean indicator that every process was requested.
+    struct timespec start;
+    struct info_wait_s *next;
+};
+typedef struct info_wait_s info_wait_t;
+
+struct quit_state_s {
+    // This struct holds the progress of quit, from quit_start to quit_finish.
+    int active;  // Boolean indicator that quit has started.
+    struct timespec start;
+    int num_running;  // The number of processes not reaped yet.
+    int num_terminated;  // The number of processes sent SIGTERM.
+};
+typedef struct quit_state_s quit_state_t;
+
+struct server_s {
+    // This struct is the state of scee in daemon mode, in which commands are
+    // received from the clients connected to a Unix domain socket.
+    const char *path;  // The path to the socket.
+    int listen_fd;
+    int epoll_fd;
+    client_t **clients;  // The connected clients, indexed by descriptor.
+    int num_clients;  // The number of entries of clients.
+    long offsets[MAX_BATCH_COMMANDS + 1];  // Where the output of each
+            // command of a batch starts in the standard output.
+    client_t *current;  // The client whose command is being executed.
+    info_wait_t *info_waits;  // The info commands waiting for replies.
+    int quit_waiting;  // Boolean indicator that quit waits for the reaping.
+    client_t *quit_client;  // The client that requested quit, or NULL.
+};
+typedef struct server_s server_t;
 ////////////////////////////////////////////////////////////////////////////////
 
 // global variable declaration
 ////////////////////////////////////////////////////////////////////////////////
+static int batch_mode = 0;  // Boolean indicator that the commands are
+        // read from a script rather than typed by the user.
+static int sigchld_fd = -1;  // signalfd that receives SIGCHLD
+static int info_fd = -1;  // signalfd that receives the replies to SIGUSR1
+static pool_t pool;  // allocator of the list nodes
+static path_t *path_table[PATH_TABLE_SIZE];  // the interned paths
+static sampler_t sampler;  // the /proc sampler
+static long path_bytes;  // the memory used by the interned paths
+static capturer_t capturer;  // the output capture thread
+static long capture_bytes;  // the memory used by the ring buffers
+static int terminal_fd = -1;  // the original standard output in daemon mode,
+        // where the output of the spawned processes goes
+static server_t server;  // the state of the daemon mode
+static quit_state_t quitting;  // the progress of quit
+static scheduler_t scheduler = { .lock = PTHREAD_MUTEX_INITIALIZER,
+        .timer_fd = -1 };  // the time-slicing scheduler
+static throttler_t throttler = { .lock = PTHREAD_MUTEX_INITIALIZER,
+        .timer_fd = -1 };  // the CPU limits
+static topology_t topology;  // the CPUs and NUMA nodes
+static cgroups_t cgroups = { .base_fd = -1,
+        .root_fd = -1 };  // the cgroups of the jobs
+static unsigned int placement_next;  // the next CPU or node of the spread
+static histogram_t histograms[NUM_OPERATIONS];  // latencies of the operations,
+        // recorded only by the main thread
+static const char *operation_names[NUM_OPERATIONS] = { "exec", "kill", "stop",
+        "cont", "list", "info", "top", "tail", "stats", "sched", "limit",
+        "quit", "fork",
+        "exec-wait", "posix_spawn", "kill(2)", "wait4" };
 ////////////////////////////////////////////////////////////////////////////////
 
 // function prototypes
 ////////////////////////////////////////////////////////////////////////////////
-int get_input(char **input, const int max_length);
+int read_command(FILE *stream, command_t *command);
+int str_tokenize(char *str, char *tokens[], int max_tokens);
 int str_split(const char *str, char ***tokens, const char *delimiters);
 void clear_screen();
+int buffer_reserve(buffer_t *buffer, size_t length);
+int buffer_printf(buffer_t *buffer, const char *format, ...);
+int buffer_write(buffer_t *buffer, int fd);
+unsigned int pid_hash(int pid);
+int index_create(pid_index_t **index);
+void index_delete(pid_index_t *index);
+int index_resize(pid_index_t *index, int capacity);
+int index_reserve(pid_index_t *index, int num_entries);
+int index_insert(pid_index_t *index, process_t *process);
+int index_remove(pid_index_t *index, int pid);
+process_t *index_search(pid_index_t *index, int pid);
+process_t *pool_alloc();
+void pool_free(process_t *node);
+unsigned int path_hash(const char *path);
+char *path_intern(const char *path);
+void path_release(char *path);
+long memory_usage(process_t *list);
 int list_create(process_t **list);
 int list_add(process_t *list, int pid, char *path);
 int list_remove(process_t *node);
@@ -79,89 +704,235 @@ int list_print(process_t *list);
 int list_search(process_t *list, process_t **result, int pid);
 int parent_signal_handling();
 int child_signal_handling();
+int process_reap(process_t *processes);
+int parse_option(char *arguments[], const char *name, int default_value);
+void format_status(char *status, const process_t *process);
+int compare_longs(const void *a, const void *b);
+long monotonic_nanoseconds();
+long elapsed_nanoseconds(const struct timespec *start);
+int histogram_index(long value);
+long histogram_bucket_limit(int index);
+void histogram_record(histogram_t *histogram, long value);
+void histogram_merge(histogram_t *histogram, histogram_t *other);
+long histogram_percentile(const histogram_t *histogram, double percentile);
+int send_signal(int pid, int signal_number);
+void signal_batch(process_t **nodes, int num_nodes, int signal_number,
+        int *results);
+int read_proc_file(int pid, const char *name, char *buffer, size_t size);
+const char *skip_fields(const char *str, int num_fields);
+int usage_parse(const char *schedstat, const char *statm, usage_t *usage);
+int usage_sample(process_t *process, long now);
+int sampler_start();
+void *sampler_run(void *argument);
+void sampler_attach(process_t *process);
+void sampler_detach(process_t *process);
+int sampler_read(const process_t *process, usage_t *usage);
+int capture_start();
+void *capture_run(void *argument);
+int capture_attach(process_t *process, int fd, int capturing,
+        const char *log_path);
+void capture_detach(process_t *process);
+void capture_append(capture_t *capture, const char *data, size_t length);
+ssize_t capture_log(capture_t *capture, char *data, size_t size);
+int log_open(const char *path, long *size);
+int log_rotate(capture_t *capture);
+double log_rate(capture_t *capture, long now);
+int capture_tail(const capture_t *capture, int num_lines, buffer_t *buffer);
+int process_tail(process_t *processes, char *arguments[]);
+int process_stats(process_t *processes, char *arguments[]);
+int sched_add(process_t *process);
+void sched_attach(process_t *process);
+void sched_detach(process_t *process, int resume);
+int sched_enable(process_t *processes, int max_running, long quantum);
+void sched_disable();
+int compare_virtual_times(const void *a, const void *b);
+void sched_tick();
+void *sched_run(void *argument);
+int sched_report(buffer_t *buffer);
+int process_sched(process_t *processes, char *arguments[]);
+long throttle_read(int schedstat_fd);
+void throttle_attach(process_t *process);
+void throttle_detach(process_t *process, int resume);
+int throttle_set(process_t *process, int cpu_limit);
+void throttle_clear();
+void throttle_tick();
+void *throttle_run(void *argument);
+int process_limit(process_t *processes, char *arguments[]);
+int cpuset_parse(const char *string, cpu_set_t *set);
+void cpuset_format(const cpu_set_t *set, char *string, size_t size);
+void topology_load();
+int placement_choose(const exec_options_t *options, cpu_set_t *cpus,
+        unsigned long *nodemask, char *description);
+int placement_apply(const cpu_set_t *cpus, unsigned long nodemask);
+void placement_restore();
+int placement_current(int pid, int *cpu);
+int parse_size(const char *string, long *size);
+int limits_apply(int pid, const exec_options_t *options);
+int cgroup_write(int dir_fd, const char *name, const char *value);
+int cgroup_enable(int dir_fd, const char *controller);
+int cgroup_start();
+void cgroup_stop();
+job_t *job_create(exec_options_t *options, int count);
+int job_attach(job_t *job, int pid);
+void job_exited(process_t *process);
+void job_release(process_t *process);
+void job_collect();
+int job_freeze(job_t *job, int frozen);
+void job_split(job_t *job, process_t *process);
+int jobs_freeze(selection_t *selection, int stop);
+void jobs_thaw();
+scee_stats_t *stats_create(int *fd);
+char **stats_environment();
+void stats_release(process_t *process);
+int stats_read(const scee_stats_t *stats, scee_stats_t *copy);
+int compare_usage(const void *a, const void *b);
+int process_top(process_t *processes, char *arguments[]);
 int process_exec(process_t *processes, char *arguments[]);
+int spawn_fork(pid_t *pid, char *arguments[], char *envp[], int output_fd,
+        int stats_fd, pid_t pgid, const sigset_t *signal_mask,
+        const exec_options_t *options);
+int process_exec_bulk(process_t *processes, int count,
+        const exec_options_t *options, char *arguments[]);
 int low_level_process_kill(process_t *process);
-int process_kill(process_t *processes, char *string_pid);
-int process_stop(process_t *processes, char *string_pid);
-int process_cont(process_t *processes, char *string_pid);
-int process_list(process_t *list);
-int process_info(process_t *processes, char *string_pid);
-int process_quit(process_t *list);
+int selection_add(selection_t *selection, process_t *node);
+int compare_pointers(const void *a, const void *b);
+int process_select(process_t *processes, char *arguments[],
+        selection_t *selection);
+int process_signal(process_t *processes, char *arguments[], int signal_number,
+        const char *action);
+int process_kill(process_t *processes, char *arguments[]);
+int process_stop(process_t *processes, char *arguments[]);
+int process_cont(process_t *processes, char *arguments[]);
+int process_list(process_t *list, char *arguments[]);
+int catches_signal(int pid, int signal_number);
+int compare_requests(const void *a, const void *b);
+int info_match(info_request_t *requests, int num_requests,
+        const struct signalfd_siginfo *siginfo, int num_signals);
+int info_collect(info_request_t *requests, int num_requests, int num_pending);
+int info_report(process_t *processes, const info_request_t *requests,
+        int num_requests, int all);
+int process_info(process_t *processes, char *arguments[]);
+int quit_start(process_t *list);
+int quit_finish(process_t *list);
+int process_quit(process_t *list, char *arguments[]);
+const task_t *task_search(const char *name);
 int task_queue();
+int server_listen(const char *path);
+int server_accept();
+void server_close(client_t *client);
+int server_update(client_t *client);
+int server_flush(client_t *client);
+int server_settle(client_t *client);
+int server_execute(process_t *processes, char *line, const task_t **task);
+int server_process(client_t *client, process_t *processes);
+int server_serve(client_t *client, process_t *processes);
+int server_wait_info(info_request_t *requests, int num_requests,
+        int num_pending, int all);
+int server_wait_quit();
+int server_respond(client_t *client, long start);
+int server_complete(process_t *processes);
+int server_timeout();
+int server_run(const char *path);
+void bench_report(const char *operation, int num_tracked, long *latencies,
+        int num_samples);
+int bench_operations(const int sizes[], int num_sizes);
 ////////////////////////////////////////////////////////////////////////////////
 
 // functions
 ////////////////////////////////////////////////////////////////////////////////
-int get_input(char **input, const int max_length) {
+int read_command(FILE *stream, command_t *command) {
     // Description
-    // This function reads a single line input from stdin. The input should
-    // be at most of length max_length. It is stored in a dynamically allocated
-    // string and a pointer to this string is stored in input. If the length of
-    // the input exceeds max_length, the value of input is not changed.
+    // This function reads a single line input from stream into command and
+    // splits it into tokens in place with str_tokenize. The input should be at
+    // most of length MAX_INPUT_LENGTH, otherwise the rest of the line is
+    // discarded. No memory is allocated.
     //
     // Returns
-    // get_input returns the length of the input read which could be equal to 0,
-    // -1 in case of failure, or if the length of the input exceeded max_length.
+    // read_command returns the number of tokens read which could be equal
+    // to 0, -1 in case of failure, at the end of the input, or if the length
+    // of the input exceeded MAX_INPUT_LENGTH.
 
     // variable declaration
-    char *temp_input;
-    size_t buffer_size;
     int input_length;
-    int return_value;  // integer placeholder for error checking
+    int c;  // a discarded character
     void *return_pointer;  // pointer placeholder for error checking
 
-    temp_input = NULL;
-    buffer_size = 0;  // NOTE Is it a good practice to include a cast here?
-            // "buffer_size = (size_t)0;"
-
-    return_value = getline(&temp_input, &buffer_size, stdin);
-    if (return_value == -1) {
-        perror("error, getline");
+    return_pointer = fgets(command->line, sizeof(command->line), stream);
+    if (return_pointer == NULL) {
+        if (ferror(stream)) {
+            perror("error, fgets");
+        }
         return -1;
     }
 
     // Store the input length.
-    input_length = strlen(temp_input);
+    input_length = strlen(command->line);
+
+    if (command->line[input_length - 1] == '\n') {
+        // Remove the trailing newline character.
+        command->line[input_length - 1] = '\0';
+    } else if (!feof(stream)) {
+        // The line didn't fit in the buffer, discard the rest of it. The last
+        // line of a script may lack a newline character, though.
+        do {
+            c = getc(stream);
+        } while ((c != '\n') && (c != EOF));
 
-    // Verify that an entire line, terminating in a newline character, was read.
-    if (temp_input[input_length - 1] != '\n') {
-        printf("Error, getline didn't read an entire line.\n");
-
-        free(temp_input);
+        printf("Error, the input was too large.");
+        printf(" Maximum permitted length: %d\n", MAX_INPUT_LENGTH);
         return -1;
     }
 
-    // Remove the trailing newline character.
-    temp_input[input_length - 1] = '\0';
+    command->num_tokens = str_tokenize(command->line, command->tokens,
+            MAX_TOKENS);
 
-    // Update the input length.
-    input_length = strlen(temp_input);
+    return command->num_tokens;
+}
 
-    // The input length should be at most equal to max_length.
-    if (input_length > max_length) {
-        printf("Error, the input was too large.");
-        printf(" Input length: %d", input_length);
-        printf(" Maximum permitted length: %d\n", max_length);
+int str_tokenize(char *str, char *tokens[], int max_tokens) {
+    // Description
+    // This function splits the string str in place into the substrings of it
+    // separated by one or more spaces or tabs, and stores pointers to them in
+    // the array tokens, followed by a terminating NULL pointer. At most
+    // max_tokens tokens are stored, so tokens must have room for
+    // max_tokens + 1 pointers.
+    //
+    // Returns
+    // str_tokenize returns the number of tokens found in str which could be
+    // equal to 0.
 
-        free(temp_input);
-        return -1;
-    }
+    // variable declaration
+    int num_tokens;
 
-    // Reallocate the temp_input char array so that its size is reduced by
-    // one byte, previously occupied by the trailing newline character.
-    return_pointer = (char *)realloc(temp_input,
-            (size_t)((input_length + 1) * sizeof(*temp_input)));
-    if (return_pointer == NULL) {
-        perror("error, realloc");
-        free(temp_input);
-        return -1;
-    } else {
-        temp_input = return_pointer;
+    num_tokens = 0;
+    for (;;) {
+        // Skip the delimiters.
+        while ((*str == ' ') || (*str == '\t')) {
+            str++;
+        }
+
+        if ((*str == '\0') || (num_tokens == max_tokens)) {
+            break;
+        }
+
+        tokens[num_tokens] = str;
+        num_tokens++;
+
+        // Find the end of the token.
+        while ((*str != '\0') && (*str != ' ') && (*str != '\t')) {
+            str++;
+        }
+
+        if (*str == '\0') {
+            break;
+        }
+        *str = '\0';
+        str++;
     }
 
-    *input = temp_input;
+    tokens[num_tokens] = NULL;
 
-    return input_length;
+    return num_tokens;
 }
 
 int str_split(const char *str, char ***tokens, const char *delimiters) {
@@ -276,771 +1047,6453 @@ void clear_screen() {
     printf("\e[1;1H\e[2J");
 }
 
-int list_create(process_t **list) {
+int buffer_reserve(buffer_t *buffer, size_t length) {
     // Description
-    // This function creates a doubly linked list of information about processes
-    // by creating and initializing its sentinel node. The address of
-    // the sentinel is stored in list.
+    // This function grows the buffer buffer, if needed, so that length more
+    // bytes fit in it. The capacity is doubled, so appending is amortized
+    // constant time.
     //
     // Returns
-    // list_create returns 0 on successful completion or -1 in case of failure.
+    // buffer_reserve returns 0 on successful completion or -1 in case of
+    // failure.
 
     // variable declaration
-    process_t *sentinel;
+    size_t capacity;
     void *return_pointer;  // pointer placeholder for error checking
 
-    return_pointer = (process_t *)malloc(1 * sizeof(process_t));
-    if (return_pointer == NULL) {
-        perror("error, malloc");
-        return -1;
-    } else {
-        sentinel = return_pointer;
+    if (buffer->length + length <= buffer->capacity) {
+        return 0;
     }
 
-    // Data initialization.
-    sentinel->pid = 0;
-    sentinel->path = NULL;
-    sentinel->stopped = 0;
+    capacity = buffer->capacity > 0 ? buffer->capacity :
+            BUFFER_INITIAL_CAPACITY;
+    while (buffer->length + length > capacity) {
+        capacity *= 2;
+    }
 
-    // Pointer initialization.
-    sentinel->next = sentinel;
-    sentinel->previous = sentinel;
+    return_pointer = realloc(buffer->data, capacity);
+    if (return_pointer == NULL) {
+        perror("error, realloc");
+        return -1;
+    }
 
-    *list = sentinel;
+    buffer->data = return_pointer;
+    buffer->capacity = capacity;
 
     return 0;
 }
 
-int list_add(process_t *list, int pid, char *path) {
+int buffer_printf(buffer_t *buffer, const char *format, ...) {
     // Description
-    // This function adds a node containing the data pid and path right after
-    // the sentinel node of the list list.
+    // This function appends to the buffer buffer the output of vsnprintf for
+    // format and the subsequent arguments.
     //
     // Returns
-    // list_add returns 0 on successful completion or -1 in case of failure.
+    // buffer_printf returns the number of bytes appended or -1 in case of
+    // failure.
 
     // variable declaration
-    process_t *node;
-    void *return_pointer;  // pointer placeholder for error checking
+    va_list arguments;
+    size_t available;
+    int length;
+    int return_value;  // integer placeholder for error checking
 
-    if (list == NULL) {
-        // list should point to a valid list.
+    // Try to fit the output in the available space first, and retry once
+    // the buffer has grown if it didn't fit.
+    available = buffer->capacity - buffer->length;
+    va_start(arguments, format);
+    length = vsnprintf(buffer->data + buffer->length, available, format,
+            arguments);
+    va_end(arguments);
+    if (length < 0) {
         return -1;
     }
 
-    // Create the new node.
-    return_pointer = (process_t *)malloc(1 * sizeof(process_t));
+    if ((size_t)length >= available) {
+        return_value = buffer_reserve(buffer, (size_t)length + 1);
+        if (return_value == -1) {
+            return -1;
+        }
+
+        va_start(arguments, format);
+        vsnprintf(buffer->data + buffer->length, (size_t)length + 1, format,
+                arguments);
+        va_end(arguments);
+    }
+
+    buffer->length += length;
+
+    return length;
+}
+
+int buffer_write(buffer_t *buffer, int fd) {
+    // Description
+    // This function writes the contents of the buffer buffer to the file
+    // descriptor fd, and empties the buffer. The output buffered by stdio is
+    // flushed first, so that the order of the output is kept.
+    //
+    // Returns
+    // buffer_write returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    size_t written;
+    ssize_t return_value;  // integer placeholder for error checking
+
+    fflush(stdout);
+
+    written = 0;
+    while (written < buffer->length) {
+        return_value = write(fd, buffer->data + written,
+                buffer->length - written);
+        if (return_value == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("error, write");
+            buffer->length = 0;
+            return -1;
+        }
+        written += return_value;
+    }
+
+    buffer->length = 0;
+
+    return 0;
+}
+
+unsigned int pid_hash(int pid) {
+    // Description
+    // This function computes the hash of the PID pid with Fibonacci hashing.
+    // Consecutive PIDs, which are common for processes spawned in a row, are
+    // spread over the whole table.
+    //
+    // Returns
+    // pid_hash returns the hash of pid.
+
+    return (unsigned int)pid * 2654435769u;
+}
+
+int index_create(pid_index_t **index) {
+    // Description
+    // This function creates an empty PID index with INDEX_INITIAL_CAPACITY
+    // slots. The address of the index is stored in index.
+    //
+    // Returns
+    // index_create returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    pid_index_t *temp_index;
+    void *return_pointer;  // pointer placeholder for error checking
+
+    return_pointer = (pid_index_t *)malloc(1 * sizeof(pid_index_t));
     if (return_pointer == NULL) {
         perror("error, malloc");
         return -1;
     } else {
-        node = return_pointer;
+        temp_index = return_pointer;
     }
 
-    // Populate the node with data.
-    node->pid = pid;
-    return_pointer = strdup(path);
+    return_pointer = (pid_slot_t *)calloc(INDEX_INITIAL_CAPACITY,
+            sizeof(pid_slot_t));
     if (return_pointer == NULL) {
-        perror("error, strdup");
+        perror("error, calloc");
+        free(temp_index);
         return -1;
     } else {
-        node->path = return_pointer;
+        temp_index->slots = return_pointer;
     }
-    node->stopped = 0;
 
-    // Add the node to the list.
-    node->next = list->next;
-    node->previous = list;
-    list->next->previous = node;
-    list->next = node;
+    temp_index->capacity = INDEX_INITIAL_CAPACITY;
+    temp_index->count = 0;
+    temp_index->length = 0;
+
+    *index = temp_index;
 
     return 0;
 }
 
-int list_remove(process_t *node) {
+void index_delete(pid_index_t *index) {
     // Description
-    // This function removes the node node from the list it is residing and
-    // subsequently deletes it.
+    // This function deletes the PID index index. The nodes it points to are
+    // not affected.
     //
     // Returns
-    // list_remove returns 0 on successful completion or -1 in case of failure.
+    // index_delete does not return any value.
 
-    // variable declaration
-
-    if ((node == NULL) || (node->next == NULL) || (node->previous == NULL)){
-        // node should point to a valid node residing in a list.
-        return -1;
+    if (index == NULL) {
+        return;
     }
 
-    // Remove the node from the list.
-    node->next->previous = node->previous;
-    node->previous->next = node->next;
-
-    // Delete the node.
-    free(node->path);
-    free(node);
-
-    return 0;
+    free(index->slots);
+    free(index);
 }
 
-int list_print(process_t *list) {
+int index_resize(pid_index_t *index, int capacity) {
     // Description
-    // This function prints the contents of the nodes of the list list.
+    // This function rebuilds the PID index index with capacity slots.
+    // capacity must be a power of 2 larger than the number of entries.
     //
     // Returns
-    // list_print returns 0 on successful completion or -1 in case of failure.
+    // index_resize returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
-    process_t *node;
+    pid_slot_t *old_slots;
+    int old_capacity;
+    unsigned int mask;
+    unsigned int position;
+    void *return_pointer;  // pointer placeholder for error checking
     int i;  // generic counter
 
-    if (list == NULL) {
-        // list should point to a valid list.
+    return_pointer = (pid_slot_t *)calloc((size_t)capacity, sizeof(pid_slot_t));
+    if (return_pointer == NULL) {
+        perror("error, calloc");
         return -1;
     }
 
-    i = 0;
-    for (node = list->next; node != list; node = node->next) {
-        i++;
-        printf("node: %d\n", i);
-        printf("\tpid: %d\n", node->pid);
-        printf("\tpath: %s\n", node->path);
-        printf("\tstopped: %d\n", node->stopped);
-        printf("\tnext: %p\n", node->next);
-        printf("\tprevious: %p\n", node->previous);
+    old_slots = index->slots;
+    old_capacity = index->capacity;
+    index->slots = return_pointer;
+    index->capacity = capacity;
+
+    // Reinsert the entries. They are all distinct, so there is no need to
+    // check for duplicates.
+    mask = (unsigned int)capacity - 1;
+    for (i = 0; i < old_capacity; i++) {
+        if (old_slots[i].pid == 0) {
+            continue;
+        }
+
+        position = pid_hash(old_slots[i].pid) & mask;
+        while (index->slots[position].pid != 0) {
+            position = (position + 1) & mask;
+        }
+        index->slots[position] = old_slots[i];
     }
 
+    free(old_slots);
+
     return 0;
 }
 
-int list_search(process_t *list, process_t **result, int pid) {
+int index_reserve(pid_index_t *index, int num_entries) {
     // Description
-    // This function searches for a node with pid of pid in the list list.
-    // It stores the address of the node found in result, or NULL, if no such
-    // node was found.
+    // This function grows the PID index index, if needed, so that num_entries
+    // more entries can be inserted without any further resizing.
     //
     // Returns
-    // list_search returns 1 if a matching node was found in the list,
-    // 0 if no matching node was found, or -1 in case of failure.
+    // index_reserve returns 0 on successful completion or -1 in case of
+    // failure.
 
     // variable declaration
-    process_t *node;
+    int capacity;
 
-    if (list == NULL) {
-        // list should point to a valid list.
-        return -1;
+    capacity = index->capacity;
+    while (2 * (index->count + num_entries) > capacity) {
+        capacity *= 2;
     }
 
-    // Store the query in the sentinel.
-    list->pid = pid;
-
-    for (node = list->next; node->pid != pid; node = node->next);
-
-    if (node == list) {
-        *result = NULL;
+    if (capacity == index->capacity) {
         return 0;
-    } else {
-        *result = node;
-        return 1;
     }
-}
 
-//static void handler_sigint(int signal) {
-//    // Description
-//    // This function is the signal handler for SIGINT.
-//    //
-//    // Returns
-//    // handler_sigint does not return any value.
-//
-//    // variable declaration
-//
-//    write(STDOUT_FILENO, "\nI can't let you do that, Dave.\n\n", 32);
-//}
+    return index_resize(index, capacity);
+}
 
-int parent_signal_handling() {
+int index_insert(pid_index_t *index, process_t *process) {
     // Description
-    // This function contains the signal handling code of the parent process
-    // of the application. It blocks all signals, except for SIGCHLD.
-    // // TODO and SIGINT.
+    // This function adds the node process to the PID index index, under
+    // the PID of the node. The index grows if it becomes half full. A node of
+    // an exited process with the same PID, which the kernel has reused, is
+    // replaced, and stays in its list until the next list command.
     //
     // Returns
-    // parent_signal_handling returns 0 on successful completion or
-    // -1 in case of failure.
+    // index_insert returns 0 on successful completion or -1 in case of failure,
+    // or if the PID is already in the index for a process that hasn't exited.
 
     // variable declaration
-    //struct sigaction action = { {0} };
-    struct sigaction action_sigchld = { {0} };
-    sigset_t signals_set;
+    unsigned int mask;
+    unsigned int position;
     int return_value;  // integer placeholder for error checking
 
-    return_value = sigfillset(&signals_set);
-    if (return_value == -1) {
-        perror("error, sigfillset");
+    if ((index == NULL) || (process == NULL) || (process->pid == 0)) {
         return -1;
     }
 
-    //return_value = sigdelset(&signals_set, SIGINT);
-    //if (return_value == -1) {
-    //    perror("error, sigdelset");
-    //    return -1;
-    //}
+    if (2 * (index->count + 1) > index->capacity) {
+        return_value = index_resize(index, 2 * index->capacity);
+        if (return_value == -1) {
+            printf("error, index_resize\n");
+            return -1;
+        }
+    }
 
-    return_value = sigdelset(&signals_set, SIGCHLD);
-    if (return_value == -1) {
-        perror("error, sigdelset");
-        return -1;
+    mask = (unsigned int)index->capacity - 1;
+    position = pid_hash(process->pid) & mask;
+    while (index->slots[position].pid != 0) {
+        if (index->slots[position].pid == process->pid) {
+            if (!index->slots[position].process->exited) {
+                return -1;
+            }
+            index->slots[position].process = process;
+            return 0;
+        }
+        position = (position + 1) & mask;
     }
 
-    return_value = sigprocmask(SIG_BLOCK, &signals_set, NULL);
-    if (return_value == -1) {
-        perror("error, sigprocmask");
+    index->slots[position].pid = process->pid;
+    index->slots[position].process = process;
+    index->count++;
+
+    return 0;
+}
+
+int index_remove(pid_index_t *index, int pid) {
+    // Description
+    // This function removes the entry with PID equal to pid from the PID index
+    // index. The entries following it in its probe sequence are shifted back,
+    // so that no tombstones are left behind and lookups stay short.
+    //
+    // Returns
+    // index_remove returns 1 if the entry was removed, 0 if there was no such
+    // entry, or -1 in case of failure.
+
+    // variable declaration
+    unsigned int mask;
+    unsigned int position;  // the slot being emptied
+    unsigned int next;  // the slot being examined for shifting back
+    unsigned int home;  // the slot an entry hashes to
+
+    if ((index == NULL) || (pid == 0)) {
         return -1;
     }
 
-    // TODO Results to an error in getline.
-    //action.sa_handler = handler_sigint;
-    //return_value = sigaction(SIGINT, &action, NULL);
+    mask = (unsigned int)index->capacity - 1;
+    position = pid_hash(pid) & mask;
+    while (index->slots[position].pid != pid) {
+        if (index->slots[position].pid == 0) {
+            return 0;
+        }
+        position = (position + 1) & mask;
+    }
+
+    next = position;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (index->slots[next].pid == 0) {
+            break;
+        }
+
+        // The entry at next can fill the empty slot only if its home slot
+        // doesn't lie cyclically in (position, next].
+        home = pid_hash(index->slots[next].pid) & mask;
+        if (((next - home) & mask) >= ((next - position) & mask)) {
+            index->slots[position] = index->slots[next];
+            position = next;
+        }
+    }
+
+    index->slots[position].pid = 0;
+    index->slots[position].process = NULL;
+    index->count--;
+
+    return 1;
+}
+
+process_t *index_search(pid_index_t *index, int pid) {
+    // Description
+    // This function searches for the entry with PID equal to pid in the PID
+    // index index.
+    //
+    // Returns
+    // index_search returns the node of the matching entry, or NULL if no
+    // such entry exists.
+
+    // variable declaration
+    unsigned int mask;
+    unsigned int position;
+
+    if ((index == NULL) || (pid == 0)) {
+        return NULL;
+    }
+
+    mask = (unsigned int)index->capacity - 1;
+    position = pid_hash(pid) & mask;
+    while (index->slots[position].pid != 0) {
+        if (index->slots[position].pid == pid) {
+            return index->slots[position].process;
+        }
+        position = (position + 1) & mask;
+    }
+
+    return NULL;
+}
+
+process_t *pool_alloc() {
+    // Description
+    // This function allocates a list node from the pool. If the free list is
+    // empty, a new chunk of POOL_CHUNK_SIZE nodes is added to it first.
+    //
+    // Returns
+    // pool_alloc returns a pointer to the node, or NULL in case of failure.
+
+    // variable declaration
+    pool_chunk_t *chunk;
+    process_t *node;
+    void *return_pointer;  // pointer placeholder for error checking
+    int i;  // generic counter
+
+    if (pool.free_nodes == NULL) {
+        return_pointer = (pool_chunk_t *)malloc(1 * sizeof(pool_chunk_t));
+        if (return_pointer == NULL) {
+            perror("error, malloc");
+            return NULL;
+        } else {
+            chunk = return_pointer;
+        }
+
+        chunk->next = pool.chunks;
+        pool.chunks = chunk;
+        pool.num_chunks++;
+
+        // Add the nodes of the chunk to the free list, in order.
+        for (i = POOL_CHUNK_SIZE - 1; i >= 0; i--) {
+            chunk->nodes[i].next = pool.free_nodes;
+            pool.free_nodes = &chunk->nodes[i];
+        }
+    }
+
+    node = pool.free_nodes;
+    pool.free_nodes = node->next;
+    pool.num_used++;
+
+    return node;
+}
+
+void pool_free(process_t *node) {
+    // Description
+    // This function returns the node node to the pool.
+    //
+    // Returns
+    // pool_free does not return any value.
+
+    node->next = pool.free_nodes;
+    pool.free_nodes = node;
+    pool.num_used--;
+}
+
+unsigned int path_hash(const char *path) {
+    // Description
+    // This function computes the FNV-1a hash of the string path.
+    //
+    // Returns
+    // path_hash returns the hash of path.
+
+    // variable declaration
+    unsigned int hash;
+
+    hash = 2166136261u;
+    for (; *path != '\0'; path++) {
+        hash = (hash ^ (unsigned char)*path) * 16777619u;
+    }
+
+    return hash;
+}
+
+char *path_intern(const char *path) {
+    // Description
+    // This function returns the interned copy of the string path, creating it
+    // if it doesn't exist, and increments its reference count. The copy must
+    // be released with path_release.
+    //
+    // Returns
+    // path_intern returns a pointer to the interned path, or NULL in case of
+    // failure.
+
+    // variable declaration
+    path_t **bucket;
+    path_t *interned;
+    int length;
+    void *return_pointer;  // pointer placeholder for error checking
+
+    bucket = &path_table[path_hash(path) % PATH_TABLE_SIZE];
+    for (interned = *bucket; interned != NULL; interned = interned->next) {
+        if (!strcmp(interned->string, path)) {
+            interned->refcount++;
+            return interned->string;
+        }
+    }
+
+    length = strlen(path);
+    return_pointer = (path_t *)malloc(sizeof(path_t) + length + 1);
+    if (return_pointer == NULL) {
+        perror("error, malloc");
+        return NULL;
+    } else {
+        interned = return_pointer;
+    }
+
+    memcpy(interned->string, path, length + 1);
+    interned->length = length;
+    interned->refcount = 1;
+    interned->next = *bucket;
+    *bucket = interned;
+    path_bytes += sizeof(path_t) + length + 1;
+
+    return interned->string;
+}
+
+void path_release(char *path) {
+    // Description
+    // This function decrements the reference count of the interned path path,
+    // and deletes it once it is no longer used.
+    //
+    // Returns
+    // path_release does not return any value.
+
+    // variable declaration
+    path_t *interned;
+    path_t **link;
+
+    if (path == NULL) {
+        return;
+    }
+
+    interned = (path_t *)(path - offsetof(path_t, string));
+    interned->refcount--;
+    if (interned->refcount > 0) {
+        return;
+    }
+
+    // Unlink the path from its bucket.
+    link = &path_table[path_hash(path) % PATH_TABLE_SIZE];
+    while (*link != interned) {
+        link = &(*link)->next;
+    }
+    *link = interned->next;
+
+    path_bytes -= sizeof(path_t) + interned->length + 1;
+    free(interned);
+}
+
+long memory_usage(process_t *list) {
+    // Description
+    // This function computes the memory used to keep track of the processes
+    // in the list list: the nodes allocated by the pool, the slots of the PID
+    // index, the interned paths, and the ring buffers of captured output.
+    //
+    // Returns
+    // memory_usage returns the number of bytes used.
+
+    return (long)pool.num_chunks * sizeof(pool_chunk_t) +
+            (long)list->index->capacity * sizeof(pid_slot_t) + path_bytes +
+            capture_bytes;
+}
+
+int list_create(process_t **list) {
+    // Description
+    // This function creates a doubly linked list of information about processes
+    // by creating and initializing its sentinel node, along with the PID index
+    // of the list. The address of the sentinel is stored in list.
+    //
+    // Returns
+    // list_create returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    process_t *sentinel;
+    pid_index_t *index;
+    void *return_pointer;  // pointer placeholder for error checking
+    int return_value;  // integer placeholder for error checking
+
+    return_pointer = (process_t *)malloc(1 * sizeof(process_t));
+    if (return_pointer == NULL) {
+        perror("error, malloc");
+        return -1;
+    } else {
+        sentinel = return_pointer;
+    }
+
+    return_value = index_create(&index);
+    if (return_value == -1) {
+        printf("error, index_create\n");
+        free(sentinel);
+        return -1;
+    }
+
+    // Data initialization.
+    sentinel->pid = 0;
+    sentinel->pgid = 0;
+    sentinel->path = NULL;
+    sentinel->stopped = 0;
+    sentinel->exited = 0;
+    sentinel->exit_status = 0;
+    memset(&sentinel->usage, 0, sizeof(sentinel->usage));
+    sentinel->sample_slot = -1;
+    sentinel->sched_slot = -1;
+    sentinel->cpu_limit = 0;
+    sentinel->throttle_slot = -1;
+    sentinel->placement = NULL;
+    sentinel->job = NULL;
+    sentinel->capture = NULL;
+    sentinel->stats = NULL;
+
+    // Pointer initialization.
+    sentinel->next = sentinel;
+    sentinel->previous = sentinel;
+    sentinel->index = index;
+
+    *list = sentinel;
+
+    return 0;
+}
+
+int list_add(process_t *list, int pid, char *path) {
+    // Description
+    // This function adds a node containing the data pid and path right after
+    // the sentinel node of the list list, and registers it in the PID index
+    // of the list. The process is assumed to lead its own process group.
+    //
+    // Returns
+    // list_add returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    process_t *node;
+    void *return_pointer;  // pointer placeholder for error checking
+    int return_value;  // integer placeholder for error checking
+
+    if (list == NULL) {
+        // list should point to a valid list.
+        return -1;
+    }
+
+    // Create the new node.
+    return_pointer = pool_alloc();
+    if (return_pointer == NULL) {
+        printf("error, pool_alloc\n");
+        return -1;
+    } else {
+        node = return_pointer;
+    }
+
+    // Populate the node with data.
+    node->pid = pid;
+    node->pgid = pid;
+    return_pointer = path_intern(path);
+    if (return_pointer == NULL) {
+        printf("error, path_intern\n");
+        pool_free(node);
+        return -1;
+    } else {
+        node->path = return_pointer;
+    }
+    node->stopped = 0;
+    node->exited = 0;
+    node->exit_status = 0;
+    memset(&node->usage, 0, sizeof(node->usage));
+    node->usage.start_time = monotonic_nanoseconds();
+    node->sched_slot = -1;
+    node->cpu_limit = 0;
+    node->throttle_slot = -1;
+    node->placement = NULL;
+    node->job = NULL;
+    node->capture = NULL;
+    node->stats = NULL;
+    node->index = list->index;
+
+    // Register the node in the index.
+    return_value = index_insert(list->index, node);
+    if (return_value == -1) {
+        printf("error, index_insert\n");
+        path_release(node->path);
+        pool_free(node);
+        return -1;
+    }
+
+    // Let the sampler and the scheduler know about the process.
+    sampler_attach(node);
+    sched_attach(node);
+
+    // Add the node to the list.
+    node->next = list->next;
+    node->previous = list;
+    list->next->previous = node;
+    list->next = node;
+    list->index->length++;
+
+    return 0;
+}
+
+int list_remove(process_t *node) {
+    // Description
+    // This function removes the node node from the list it is residing and
+    // from the PID index of the list, and subsequently deletes it.
+    //
+    // Returns
+    // list_remove returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+
+    if ((node == NULL) || (node->next == NULL) || (node->previous == NULL)){
+        // node should point to a valid node residing in a list.
+        return -1;
+    }
+
+    // Remove the node from the sampler, the scheduler, the throttler, its job,
+    // the capturer, the index, and the list. A process the scheduler or
+    // the throttler has stopped is resumed, so that it can handle a SIGTERM.
+    sampler_detach(node);
+    sched_detach(node, 1);
+    throttle_detach(node, 1);
+    job_release(node);
+    capture_detach(node);
+    stats_release(node);
+    if (index_search(node->index, node->pid) == node) {
+        // Otherwise a new process with the same PID has replaced the node.
+        index_remove(node->index, node->pid);
+    }
+    node->next->previous = node->previous;
+    node->previous->next = node->next;
+    node->index->length--;
+
+    // Delete the node.
+    path_release(node->path);
+    path_release(node->placement);
+    pool_free(node);
+
+    return 0;
+}
+
+int list_print(process_t *list) {
+    // Description
+    // This function prints the contents of the nodes of the list list.
+    //
+    // Returns
+    // list_print returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    process_t *node;
+    int i;  // generic counter
+
+    if (list == NULL) {
+        // list should point to a valid list.
+        return -1;
+    }
+
+    i = 0;
+    for (node = list->next; node != list; node = node->next) {
+        i++;
+        printf("node: %d\n", i);
+        printf("\tpid: %d\n", node->pid);
+        printf("\tpath: %s\n", node->path);
+        printf("\tstopped: %d\n", node->stopped);
+        printf("\tnext: %p\n", node->next);
+        printf("\tprevious: %p\n", node->previous);
+    }
+
+    return 0;
+}
+
+int list_search(process_t *list, process_t **result, int pid) {
+    // Description
+    // This function searches for a node with pid of pid in the list list,
+    // using the PID index of the list. It stores the address of the node found
+    // in result, or NULL, if no such node was found.
+    //
+    // Returns
+    // list_search returns 1 if a matching node was found in the list,
+    // 0 if no matching node was found, or -1 in case of failure.
+
+    // variable declaration
+    process_t *node;
+
+    if (list == NULL) {
+        // list should point to a valid list.
+        return -1;
+    }
+
+    node = index_search(list->index, pid);
+
+    *result = node;
+    if (node == NULL) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
+
+//static void handler_sigint(int signal) {
+//    // Description
+//    // This function is the signal handler for SIGINT.
+//    //
+//    // Returns
+//    // handler_sigint does not return any value.
+//
+//    // variable declaration
+//
+//    write(STDOUT_FILENO, "\nI can't let you do that, Dave.\n\n", 32);
+//}
+
+int parent_signal_handling() {
+    // Description
+    // This function contains the signal handling code of the parent process
+    // of the application. It blocks all signals and creates the signalfd
+    // sigchld_fd, through which process_reap is notified of exited children,
+    // and the signalfd info_fd, through which process_info receives
+    // the replies of the children to SIGUSR1.
+    // // TODO and SIGINT.
+    //
+    // Returns
+    // parent_signal_handling returns 0 on successful completion or
+    // -1 in case of failure.
+
+    // variable declaration
+    //struct sigaction action = { {0} };
+    struct sigaction action_sigchld;
+    sigset_t signals_set;
+    int return_value;  // integer placeholder for error checking
+
+    memset(&action_sigchld, 0, sizeof(action_sigchld));
+
+    return_value = sigfillset(&signals_set);
+    if (return_value == -1) {
+        perror("error, sigfillset");
+        return -1;
+    }
+
+    //return_value = sigdelset(&signals_set, SIGINT);
+    //if (return_value == -1) {
+    //    perror("error, sigdelset");
+    //    return -1;
+    //}
+
+    return_value = sigprocmask(SIG_BLOCK, &signals_set, NULL);
+    if (return_value == -1) {
+        perror("error, sigprocmask");
+        return -1;
+    }
+
+    // TODO Results to an error in getline.
+    //action.sa_handler = handler_sigint;
+    //return_value = sigaction(SIGINT, &action, NULL);
     //if (return_value == -1) {
     //    perror("error, sigaction");
     //    return -1;
     //}
 
-    // Stop terminated child processes from becoming defunct.
-    // Improved implementation of http://stackoverflow.com/a/6718997
-    action_sigchld.sa_handler = SIG_IGN;
-    return_value = sigaction(SIGCHLD, &action_sigchld, NULL);
+    // SIGCHLD must keep its default disposition, if it was ignored the
+    // terminated child processes would be discarded without notice.
+    action_sigchld.sa_handler = SIG_DFL;
+    return_value = sigaction(SIGCHLD, &action_sigchld, NULL);
+    if (return_value == -1) {
+        perror("error, sigaction");
+        return -1;
+    }
+
+    // SIGCHLD is blocked, so it is delivered only through the signalfd.
+    return_value = sigemptyset(&signals_set);
+    if (return_value == -1) {
+        perror("error, sigemptyset");
+        return -1;
+    }
+    return_value = sigaddset(&signals_set, SIGCHLD);
+    if (return_value == -1) {
+        perror("error, sigaddset");
+        return -1;
+    }
+
+    sigchld_fd = signalfd(-1, &signals_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (sigchld_fd == -1) {
+        perror("error, signalfd");
+        return -1;
+    }
+
+    return_value = sigemptyset(&signals_set);
+    if (return_value == -1) {
+        perror("error, sigemptyset");
+        return -1;
+    }
+    return_value = sigaddset(&signals_set, SCEE_INFO_SIGNAL);
+    if (return_value == -1) {
+        perror("error, sigaddset");
+        return -1;
+    }
+
+    info_fd = signalfd(-1, &signals_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (info_fd == -1) {
+        perror("error, signalfd");
+        return -1;
+    }
+
+    return 0;
+}
+
+int child_signal_handling() {
+    // Description
+    // This function contains the signal handling code of the child processes
+    // of the application. It unblocks the signals SIGTERM, SIGSTOP, SIGCONT,
+    // and SIGUSR1.
+    //
+    // Returns
+    // child_signal_handling returns 0 on successful completion or
+    // -1 in case of failure.
+
+    // variable declaration
+    sigset_t signals_set;
+    int return_value;  // integer placeholder for error checking
+
+    return_value = sigemptyset(&signals_set);
+    if (return_value == -1) {
+        perror("error, sigemptyset");
+        return -1;
+    }
+
+    return_value = sigaddset(&signals_set, SIGTERM);
+    if (return_value == -1) {
+        perror("error, sigaddset");
+        return -1;
+    }
+    return_value = sigaddset(&signals_set, SIGSTOP);
+    if (return_value == -1) {
+        perror("error, sigaddset");
+        return -1;
+    }
+    return_value = sigaddset(&signals_set, SIGCONT);
+    if (return_value == -1) {
+        perror("error, sigaddset");
+        return -1;
+    }
+    return_value = sigaddset(&signals_set, SIGUSR1);
+    if (return_value == -1) {
+        perror("error, sigaddset");
+        return -1;
+    }
+
+    return_value = sigprocmask(SIG_UNBLOCK, &signals_set, NULL);
+    if (return_value == -1) {
+        perror("error, sigprocmask");
+        return -1;
+    }
+
+    return 0;
+}
+
+int compare_longs(const void *a, const void *b) {
+    // Description
+    // This function compares the long integers pointed to by a and b, for use
+    // with qsort.
+    //
+    // Returns
+    // compare_longs returns a negative value, 0, or a positive value, if a is
+    // less than, equal to, or greater than b, respectively.
+
+    // variable declaration
+    long x = *(const long *)a;
+    long y = *(const long *)b;
+
+    return (x > y) - (x < y);
+}
+
+int process_reap(process_t *processes) {
+    // Description
+    // This function reaps the child processes that have terminated since it
+    // was last called, and marks their nodes in processes as exited, storing
+    // their exit status and their resource usage as reported by wait4,
+    // except for the context switches, read from schedstat like those of the
+    // running processes. It does nothing unless SIGCHLD has been received
+    // through sigchld_fd, so its cost doesn't depend on the number of
+    // processes in the list.
+    //
+    // Returns
+    // process_reap returns the number of nodes marked as exited or -1 in case
+    // of failure.
+
+    // variable declaration
+    struct signalfd_siginfo siginfo[16];
+    siginfo_t child_info;
+    struct rusage rusage;
+    process_t *node;
+    char schedstat[MAX_PROC_FILE_LENGTH];
+    long context_switches;
+    pid_t pid;
+    int status;
+    int num_reaped;
+    long start;
+    ssize_t num_read;
+    int return_value;  // integer placeholder for error checking
+
+    if (sigchld_fd == -1) {
+        return 0;
+    }
+
+    // Drain the signalfd. Multiple SIGCHLD signals may be merged into one,
+    // so the children are then collected with waitpid until none is left.
+    num_read = read(sigchld_fd, siginfo, sizeof(siginfo));
+    if (num_read == -1) {
+        if (errno == EAGAIN) {
+            return 0;
+        }
+        perror("error, read");
+        return -1;
+    }
+    while (read(sigchld_fd, siginfo, sizeof(siginfo)) > 0);
+
+    num_reaped = 0;
+    for (;;) {
+        // Find the next exited child without reaping it, so that it leaves
+        // the scheduler and the throttler, whose threads signal it, while its
+        // PID can't be reused yet.
+        child_info.si_pid = 0;
+        return_value = waitid(P_ALL, 0, &child_info,
+                WEXITED | WNOHANG | WNOWAIT);
+        if (return_value == -1) {
+            if (errno == ECHILD) {
+                break;
+            }
+            perror("error, waitid");
+            return -1;
+        } else if (child_info.si_pid == 0) {
+            break;
+        }
+
+        // The context switches are counted from schedstat, as for the
+        // running processes, which is still readable until the child is
+        // reaped.
+        return_value = list_search(processes, &node, (int)child_info.si_pid);
+        context_switches = -1;
+        if (return_value == 1) {
+            sched_detach(node, 0);
+            throttle_detach(node, 0);
+            if (read_proc_file(node->pid, "schedstat", schedstat,
+                    sizeof(schedstat)) > 0) {
+                context_switches = strtol(skip_fields(schedstat, 2), NULL,
+                        10);
+            }
+        }
+
+        start = monotonic_nanoseconds();
+        pid = wait4(child_info.si_pid, &status, WNOHANG, &rusage);
+        histogram_record(&histograms[OPERATION_WAIT4],
+                monotonic_nanoseconds() - start);
+        if (pid <= 0) {
+            perror("error, wait4");
+            return -1;
+        }
+
+        if (return_value == 1) {
+            job_exited(node);
+            node->exited = 1;
+            node->exit_status = status;
+            node->usage.end_time = monotonic_nanoseconds();
+            node->usage.cpu_time =
+                    (rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) *
+                    1000000000L + (rusage.ru_utime.tv_usec +
+                    rusage.ru_stime.tv_usec) * 1000L;
+            node->usage.rss = rusage.ru_maxrss;
+            if (context_switches != -1) {
+                node->usage.context_switches = context_switches;
+            }
+            node->usage.cpu_percent = 0.0;
+            num_reaped++;
+        }
+    }
+
+    // The cgroups of the jobs that were waiting for these processes to exit
+    // can be removed.
+    if (cgroups.jobs != NULL) {
+        job_collect();
+    }
+
+    return num_reaped;
+}
+
+int parse_option(char *arguments[], const char *name, int default_value) {
+    // Description
+    // This function searches arguments for the option name, followed by
+    // an integer value, as in "--limit 10".
+    //
+    // Returns
+    // parse_option returns the value of the option, or default_value if
+    // the option isn't present in arguments.
+
+    // variable declaration
+    int i;  // generic counter
+
+    for (i = 0; arguments[i] != NULL; i++) {
+        if (!strcmp(arguments[i], name) && (arguments[i + 1] != NULL)) {
+            return atoi(arguments[i + 1]);
+        }
+    }
+
+    return default_value;
+}
+
+long monotonic_nanoseconds() {
+    // Description
+    // This function reads the monotonic clock.
+    //
+    // Returns
+    // monotonic_nanoseconds returns the time in nanoseconds.
+
+    // variable declaration
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+long elapsed_nanoseconds(const struct timespec *start) {
+    // Description
+    // This function computes the time elapsed since start on the monotonic
+    // clock.
+    //
+    // Returns
+    // elapsed_nanoseconds returns the elapsed time in nanoseconds.
+
+    // variable declaration
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1000000000L +
+            (now.tv_nsec - start->tv_nsec);
+}
+
+int histogram_index(long value) {
+    // Description
+    // This function maps value to a bucket of a histogram. Negative values
+    // are counted as 0.
+    //
+    // Returns
+    // histogram_index returns the index of the bucket of value.
+
+    // variable declaration
+    int magnitude;  // the position of the most significant bit of value
+
+    if (value < (1L << HISTOGRAM_SUB_BITS)) {
+        return (value < 0) ? 0 : (int)value;
+    }
+
+    magnitude = 63 - __builtin_clzl((unsigned long)value);
+
+    return ((magnitude - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS) +
+            (int)((value >> (magnitude - HISTOGRAM_SUB_BITS)) &
+            ((1L << HISTOGRAM_SUB_BITS) - 1));
+}
+
+long histogram_bucket_limit(int index) {
+    // Description
+    // This function computes the largest value that maps to the bucket index
+    // of a histogram.
+    //
+    // Returns
+    // histogram_bucket_limit returns the largest value of the bucket.
+
+    // variable declaration
+    long sub_bucket;  // the HISTOGRAM_SUB_BITS most significant bits
+    int shift;  // the base 2 logarithm of the width of the bucket
+
+    if (index < (1 << HISTOGRAM_SUB_BITS)) {
+        return index;
+    }
+
+    sub_bucket = (1L << HISTOGRAM_SUB_BITS) +
+            (index & ((1 << HISTOGRAM_SUB_BITS) - 1));
+    shift = (index >> HISTOGRAM_SUB_BITS) - 1;
+
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void histogram_record(histogram_t *histogram, long value) {
+    // Description
+    // This function adds value, a latency in nanoseconds, to histogram. It
+    // only increments a bucket, so that it can be called on every command and
+    // system call.
+    //
+    // Returns
+    // histogram_record does not return any value.
+
+    // variable declaration
+
+    histogram->buckets[histogram_index(value)]++;
+    histogram->count++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+void histogram_merge(histogram_t *histogram, histogram_t *other) {
+    // Description
+    // This function adds the values recorded in the histogram other to
+    // histogram, and clears other.
+    //
+    // Returns
+    // histogram_merge does not return any value.
+
+    // variable declaration
+    int i;  // generic counter
+
+    if (other->count == 0) {
+        return;
+    }
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        histogram->buckets[i] += other->buckets[i];
+    }
+    histogram->count += other->count;
+    if (other->max > histogram->max) {
+        histogram->max = other->max;
+    }
+    memset(other, 0, sizeof(*other));
+}
+
+long histogram_percentile(const histogram_t *histogram, double percentile) {
+    // Description
+    // This function computes the value below which percentile percent of
+    // the values recorded in histogram lie. The value is the upper limit of
+    // its bucket, but never more than the largest recorded value.
+    //
+    // Returns
+    // histogram_percentile returns the value in nanoseconds, or 0 if
+    // the histogram is empty.
+
+    // variable declaration
+    long rank;  // the number of values up to the percentile
+    long num_counted;
+    int i;  // generic counter
+
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    rank = (long)(percentile / 100.0 * histogram->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    num_counted = 0;
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        num_counted += histogram->buckets[i];
+        if (num_counted >= rank) {
+            break;
+        }
+    }
+
+    if ((i == HISTOGRAM_BUCKETS) ||
+            (histogram_bucket_limit(i) > histogram->max)) {
+        return histogram->max;
+    }
+
+    return histogram_bucket_limit(i);
+}
+
+int send_signal(int pid, int signal_number) {
+    // Description
+    // This function sends the signal signal_number to the process with PID
+    // pid with kill, recording the latency of the system call.
+    //
+    // Returns
+    // send_signal returns the return value of kill.
+
+    // variable declaration
+    long start;
+    int return_value;  // integer placeholder for error checking
+
+    start = monotonic_nanoseconds();
+    return_value = kill((pid_t)pid, signal_number);
+    histogram_record(&histograms[OPERATION_SIGNAL],
+            monotonic_nanoseconds() - start);
+
+    return return_value;
+}
+
+void signal_batch(process_t **nodes, int num_nodes, int signal_number,
+        int *results) {
+    // Description
+    // This function sends the signal signal_number to the processes of
+    // the num_nodes nodes of nodes and stores the errno value of each failed
+    // kill, or 0, in results. The signals are sent in a single pass over
+    // nodes, which is only read, so that the callers update the list
+    // afterwards, for all of the processes at once.
+    //
+    // Returns
+    // signal_batch does not return any value.
+
+    // variable declaration
+    int i;  // generic counter
+
+    for (i = 0; i < num_nodes; i++) {
+        results[i] = (send_signal(nodes[i]->pid, signal_number) == -1) ?
+                errno : 0;
+    }
+}
+
+int process_exec(process_t *processes, char *arguments[]) {
+    // Description
+    // This function spawns a new process of the executable file specified in
+    // the path which is the first element of arguments and adds a node
+    // containing information about it in processes. If the first elements of
+    // arguments are "-n" and a number N, N processes of the file are spawned
+    // with process_exec_bulk instead. If they are preceded by "--capture" or
+    // by "--log" and the path to a log file, or both, the standard output and
+    // error of the processes are connected to a pipe drained by the capturer
+    // instead of the terminal, into a ring buffer, a log file, or both.
+    // "--cpu-limit" and a percentage throttles the processes to that share
+    // of a CPU. "--cpus" and a list of CPUs, "--spread" and cpu or node, and
+    // "--membind" place the processes with placement_choose. "--rlimit-as",
+    // "--rlimit-cpu", and "--rlimit-nofile" limit every process with
+    // prlimit, "--memory-max" and "--cpu-max" the whole job through its
+    // cgroup, as set up by job_create.
+    //
+    // The child reports the outcome of execv through a status pipe that is
+    // closed on exec. If execv succeeds the parent reads end of file,
+    // otherwise it reads the errno value of the failure. The parent waits
+    // only as long as the child takes to reach execv. The child gets its
+    // statistics page with the environment of stats_environment, or
+    // the environment of scee if the page couldn't be created.
+    //
+    // Returns
+    // process_exec returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    int pid; // TODO Should it be pid_t instead?
+    char path[MAX_PATH_LENGTH + 1];
+    int status_pipe[2];  // The read and write ends of the status pipe.
+    int output_pipe[2];  // The read and write ends of the output pipe.
+    scee_stats_t *stats;  // The statistics page of the process.
+    int stats_fd;  // The file of the statistics page.
+    char **envp;  // The environment of the process, if it has the page.
+    exec_options_t options;
+    int redirect;  // Boolean indicator that the output goes to a pipe.
+    int place;  // Boolean indicator that the process is placed.
+    cpu_set_t cpus;  // The CPUs the process is placed on.
+    unsigned long nodemask;  // The NUMA nodes of its memory, or 0.
+    char placement[MAX_PLACEMENT_LENGTH + 1];
+    int count;  // The number of processes of exec -n.
+    int exec_errno;  // The errno value reported by the child.
+    ssize_t num_read;
+    long spawn_time;  // The time of the fork, the start of the process.
+    long start;
+    int return_value;  // integer placeholder for error checking
+
+    memset(&options, 0, sizeof(options));
+    options.spread = SPREAD_NONE;
+    while (arguments[0] != NULL) {
+        if (!strcmp(arguments[0], "--capture")) {
+            options.capture = 1;
+            arguments++;
+        } else if (!strcmp(arguments[0], "--log") && (arguments[1] != NULL)) {
+            options.log_path = arguments[1];
+            arguments += 2;
+        } else if (!strcmp(arguments[0], "--cpu-limit") &&
+                (arguments[1] != NULL)) {
+            options.cpu_limit = atoi(arguments[1]);
+            if ((options.cpu_limit < 1) ||
+                    (options.cpu_limit > MAX_CPU_LIMIT)) {
+                printf("error, the CPU limit must be between 1%% and %d%%\n",
+                        MAX_CPU_LIMIT);
+                return 0;
+            }
+            arguments += 2;
+        } else if (!strcmp(arguments[0], "--cpus") && (arguments[1] != NULL)) {
+            if (cpuset_parse(arguments[1], &options.cpus) == -1) {
+                printf("error, %s is not a valid list of CPUs\n",
+                        arguments[1]);
+                return 0;
+            }
+            options.has_cpus = 1;
+            arguments += 2;
+        } else if (!strcmp(arguments[0], "--spread") &&
+                (arguments[1] != NULL)) {
+            if (!strcmp(arguments[1], "cpu")) {
+                options.spread = SPREAD_CPU;
+            } else if (!strcmp(arguments[1], "node")) {
+                options.spread = SPREAD_NODE;
+            } else {
+                printf("error, the spread must be cpu or node\n");
+                return 0;
+            }
+            arguments += 2;
+        } else if (!strcmp(arguments[0], "--membind")) {
+            options.membind = 1;
+            arguments++;
+        } else if ((!strcmp(arguments[0], "--rlimit-as") ||
+                !strcmp(arguments[0], "--memory-max")) &&
+                (arguments[1] != NULL)) {
+            if (parse_size(arguments[1], !strcmp(arguments[0], "--rlimit-as") ?
+                    &options.rlimit_as : &options.memory_max) == -1) {
+                printf("error, %s is not a valid size\n", arguments[1]);
+                return 0;
+            }
+            arguments += 2;
+        } else if ((!strcmp(arguments[0], "--rlimit-cpu") ||
+                !strcmp(arguments[0], "--rlimit-nofile")) &&
+                (arguments[1] != NULL)) {
+            if (atol(arguments[1]) <= 0) {
+                printf("error, %s requires a positive number\n",
+                        arguments[0]);
+                return 0;
+            }
+            if (!strcmp(arguments[0], "--rlimit-cpu")) {
+                options.rlimit_cpu = atol(arguments[1]);
+            } else {
+                options.rlimit_nofile = atol(arguments[1]);
+            }
+            arguments += 2;
+        } else if (!strcmp(arguments[0], "--cpu-max") &&
+                (arguments[1] != NULL)) {
+            options.cpu_max = atoi(arguments[1]);
+            if ((options.cpu_max < 1) || (options.cpu_max > MAX_CPU_LIMIT)) {
+                printf("error, the CPU maximum must be between 1%% and %d%%\n",
+                        MAX_CPU_LIMIT);
+                return 0;
+            }
+            arguments += 2;
+        } else {
+            break;
+        }
+    }
+    redirect = options.capture || (options.log_path != NULL);
+    place = options.has_cpus || (options.spread != SPREAD_NONE) ||
+            options.membind;
+    if (redirect && !capturer.running) {
+        printf("error, output capture is not available\n");
+        return 0;
+    }
+
+    // process_exec requires a valid path.
+    if (arguments[0] == NULL) {
+        printf("error, " ANSI_BOLD "exec" ANSI_RESET " requires a valid PATH\n");
+        return 0;
+    }
+
+    if (!strcmp(arguments[0], "-n")) {
+        if ((arguments[1] == NULL) || (arguments[2] == NULL)) {
+            printf("error, " ANSI_BOLD "exec -n" ANSI_RESET
+                    " requires a count and a valid PATH\n");
+            return 0;
+        }
+
+        count = atoi(arguments[1]);
+        options.job = job_create(&options, count > 0 ? count : 1);
+        return process_exec_bulk(processes, count, &options, &arguments[2]);
+    }
+
+    if (place && (placement_choose(&options, &cpus, &nodemask,
+            placement) == -1)) {
+        printf("error, there are no CPUs to place the process on\n");
+        return 0;
+    }
+
+    // A job left without processes is removed by job_collect.
+    options.job = job_create(&options, 1);
+
+    // Store the path to the executable file.
+    strncpy(path, arguments[0], MAX_PATH_LENGTH);
+    path[MAX_PATH_LENGTH] = '\0';
+
+    return_value = pipe2(status_pipe, O_CLOEXEC);
+    if (return_value == -1) {
+        perror("error, pipe2");
+        return -1;
+    }
+
+    if (redirect) {
+        return_value = pipe2(output_pipe, O_CLOEXEC);
+        if (return_value == -1) {
+            perror("error, pipe2");
+            close(status_pipe[0]);
+            close(status_pipe[1]);
+            return -1;
+        }
+    }
+
+    // The process works without a statistics page, info then signals it.
+    stats = stats_create(&stats_fd);
+    envp = NULL;
+    if (stats != NULL) {
+        envp = stats_environment();
+        if (envp == NULL) {
+            close(stats_fd);
+            munmap(stats, SCEE_STATS_SIZE);
+            stats = NULL;
+        }
+    }
+
+    // Flush the buffered output so that the child doesn't inherit it.
+    fflush(stdout);
+
+    // fork
+    spawn_time = monotonic_nanoseconds();
+    return_value = (int)fork();
+    if (return_value != 0) {
+        histogram_record(&histograms[OPERATION_FORK],
+                monotonic_nanoseconds() - spawn_time);
+    }
+    if (return_value == -1) {
+        perror("error, fork");
+        close(status_pipe[0]);
+        close(status_pipe[1]);
+        if (redirect) {
+            close(output_pipe[0]);
+            close(output_pipe[1]);
+        }
+        if (stats != NULL) {
+            close(stats_fd);
+            munmap(stats, SCEE_STATS_SIZE);
+        }
+        free(envp);
+        return -1;
+    } else if (return_value == 0) {
+        // child code
+        close(status_pipe[0]);
+
+        // Both standard output and error go to the same pipe, so that their
+        // order is kept. dup2 clears close-on-exec on the copies.
+        if (redirect) {
+            dup2(output_pipe[1], STDOUT_FILENO);
+            dup2(output_pipe[1], STDERR_FILENO);
+        } else if (terminal_fd != -1) {
+            // In daemon mode the standard output of scee is a memory file.
+            dup2(terminal_fd, STDOUT_FILENO);
+        }
+        if (stats != NULL) {
+            dup2(stats_fd, SCEE_STATS_FD);
+        }
+
+        // Lead a new process group, so that the process can be signalled
+        // with killpg.
+        setpgid(0, 0);
+
+        return_value = child_signal_handling();
+        if (return_value == -1) {
+            printf("error, child_signal_handling\n");
+        }
+
+        if (place) {
+            return_value = placement_apply(&cpus, nodemask);
+            if (return_value == -1) {
+                printf("error, placement_apply\n");
+            }
+        }
+
+        // Enter the cgroup of the job and apply the limits before execv, so
+        // that the program runs within them from the start.
+        if ((options.job != NULL) && (job_attach(options.job, 0) == -1)) {
+            perror("error, cgroup.procs");
+        }
+        return_value = limits_apply(0, &options);
+        if (return_value == -1) {
+            perror("error, prlimit");
+        }
+
+        execve(path, arguments, stats != NULL ? envp : environ);
+
+        // execv returned, report the failure to the parent.
+        exec_errno = errno;
+        return_value = write(status_pipe[1], &exec_errno, sizeof(exec_errno));
+        _exit(EXEC_FAILURE_STATUS);
+    } else {
+        // parent code
+        pid = return_value;
+        close(status_pipe[1]);
+        if (redirect) {
+            close(output_pipe[1]);
+        }
+        if (stats != NULL) {
+            close(stats_fd);
+        }
+        free(envp);
+
+        // Also set the process group here, so that it is set whichever
+        // process runs first.
+        setpgid(pid, pid);
+
+        // Wait for execv to either succeed, closing the pipe, or to fail.
+        start = monotonic_nanoseconds();
+        do {
+            num_read = read(status_pipe[0], &exec_errno, sizeof(exec_errno));
+        } while ((num_read == -1) && (errno == EINTR));
+        histogram_record(&histograms[OPERATION_EXEC_WAIT],
+                monotonic_nanoseconds() - start);
+        close(status_pipe[0]);
+
+        // Only a whole errno value reports a failed execv. If the read
+        // failed, the outcome is unknown, but the child exists and is added
+        // to the list anyway, so that it can be killed and reaped.
+        if (num_read == -1) {
+            perror("error, read");
+        }
+        if (num_read != (ssize_t)sizeof(exec_errno)) {
+            // The status pipe was closed by a successful execv.
+            return_value = list_add(processes, pid, path);
+            if (return_value == -1) {
+                printf("error, list_add\n");
+                if (redirect) {
+                    close(output_pipe[0]);
+                }
+                if (stats != NULL) {
+                    munmap(stats, SCEE_STATS_SIZE);
+                }
+            } else {
+                // list_add places the new node right after the sentinel.
+                processes->next->usage.start_time = spawn_time;
+                processes->next->stats = stats;
+                if (place) {
+                    processes->next->placement = path_intern(placement);
+                }
+                if (options.job != NULL) {
+                    processes->next->job = options.job;
+                    options.job->num_processes++;
+                    options.job->num_alive++;
+                }
+                if (options.cpu_limit > 0) {
+                    throttle_set(processes->next, options.cpu_limit);
+                }
+                if (redirect) {
+                    return_value = capture_attach(processes->next,
+                            output_pipe[0], options.capture, options.log_path);
+                    if (return_value == -1) {
+                        printf("error, capture_attach\n");
+                    }
+                }
+            }
+
+            printf("a process with PID %d was spawned\n", pid);
+        } else {
+            if (redirect) {
+                close(output_pipe[0]);
+            }
+            if (stats != NULL) {
+                munmap(stats, SCEE_STATS_SIZE);
+            }
+            printf("error in executing the program: %s;", strerror(exec_errno));
+            printf(" nothing was added to the process list\n");
+        }
+    }
+
+    return 0;
+}
+
+int spawn_fork(pid_t *pid, char *arguments[], char *envp[], int output_fd,
+        int stats_fd, pid_t pgid, const sigset_t *signal_mask,
+        const exec_options_t *options) {
+    // Description
+    // This function spawns a process of the executable file specified in
+    // the path which is the first element of arguments with fork, for
+    // process_exec_bulk, when posix_spawn can't set the child up: the child
+    // enters the cgroup of the job of options and gets their resource limits
+    // before execv, so that the program never runs outside of them. Its
+    // standard output and error go to output_fd unless it is -1, its
+    // statistics page stats_fd, unless it is -1, to SCEE_STATS_FD, and it
+    // joins the process group pgid, or leads its own if pgid is 0, with
+    // the signal mask signal_mask and the environment envp. The PID of
+    // the child is stored in pid.
+    //
+    // scee is multithreaded, so the child only makes async-signal-safe calls
+    // until execv: another thread may have held a lock of the C library at
+    // the time of fork. A failure to set it up is reported through the status
+    // pipe like one of execv, and the child exits.
+    //
+    // Returns
+    // spawn_fork returns 0 on successful completion or an error number, as
+    // posix_spawn does.
+
+    // variable declaration
+    int status_pipe[2];  // The read and write ends of the status pipe.
+    int exec_errno;  // The errno value reported by the child.
+    ssize_t num_read;
+    int return_value;  // integer placeholder for error checking
+
+    return_value = pipe2(status_pipe, O_CLOEXEC);
+    if (return_value == -1) {
+        return errno;
+    }
+
+    return_value = (int)fork();
+    if (return_value == -1) {
+        exec_errno = errno;
+        close(status_pipe[0]);
+        close(status_pipe[1]);
+        return exec_errno;
+    } else if (return_value == 0) {
+        // child code
+        close(status_pipe[0]);
+
+        if (output_fd != -1) {
+            dup2(output_fd, STDOUT_FILENO);
+            dup2(output_fd, STDERR_FILENO);
+        } else if (terminal_fd != -1) {
+            dup2(terminal_fd, STDOUT_FILENO);
+        }
+        if (stats_fd != -1) {
+            dup2(stats_fd, SCEE_STATS_FD);
+        }
+        setpgid(0, pgid);
+        sigprocmask(SIG_SETMASK, signal_mask, NULL);
+
+        // Writing 0 to cgroup.procs moves the writer, like job_attach does,
+        // without formatting the PID.
+        if ((options->job != NULL) &&
+                (write(options->job->procs_fd, "0", 1) != 1)) {
+            return_value = -1;
+        } else {
+            return_value = limits_apply(0, options);
+        }
+        if (return_value == 0) {
+            execve(arguments[0], arguments, envp);
+        }
+
+        // The set up or execv failed, report it to the parent.
+        exec_errno = errno;
+        return_value = write(status_pipe[1], &exec_errno, sizeof(exec_errno));
+        _exit(EXEC_FAILURE_STATUS);
+    }
+
+    // parent code
+    *pid = (pid_t)return_value;
+    close(status_pipe[1]);
+    setpgid(*pid, pgid != 0 ? pgid : *pid);
+
+    // Wait for execv to either succeed, closing the pipe, or to fail.
+    exec_errno = 0;
+    do {
+        num_read = read(status_pipe[0], &exec_errno, sizeof(exec_errno));
+    } while ((num_read == -1) && (errno == EINTR));
+    close(status_pipe[0]);
+    if (num_read == (ssize_t)sizeof(exec_errno)) {
+        // The failed child is reaped through sigchld_fd.
+        return exec_errno;
+    }
+
+    return 0;
+}
+
+int process_exec_bulk(process_t *processes, int count,
+        const exec_options_t *options, char *arguments[]) {
+    // Description
+    // This function spawns count processes of the executable file specified
+    // in the path which is the first element of arguments, and adds nodes
+    // containing information about them in processes in a single pass.
+    //
+    // The processes are spawned with posix_spawn, which avoids copying the
+    // page tables of scee for every child and reports execution failures
+    // directly. The signal mask of the children is set up the same way as
+    // child_signal_handling does. They are all placed in the process group
+    // of the first one, so that they can be signalled with a single killpg.
+    // The options options apply to every process: if capture is set or
+    // log_path isn't NULL, the standard output and error of every process are
+    // connected to its own pipe, drained by the capturer into a ring buffer,
+    // the log file log_path followed by the PID of the process, or both.
+    // posix_spawn can't set the CPU affinity and memory policy of a child,
+    // so the placement of every process is applied to the calling thread
+    // right before spawning it, for the process to inherit, and undone
+    // afterwards. Nor can it set the cgroup and the resource limits of
+    // a child, so the processes of a job or with limits are spawned with
+    // spawn_fork instead. The processes that get a statistics page get
+    // the environment of stats_environment. The latency percentiles of
+    // the spawns are printed afterwards.
+    //
+    // Returns
+    // process_exec_bulk returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    posix_spawnattr_t attributes;
+    posix_spawn_file_actions_t file_actions;
+    sigset_t signals_set;
+    pid_t *pids;
+    int *output_fds;  // The read ends of the output pipes, if redirected.
+    scee_stats_t **stats;  // The statistics pages of the processes.
+    char **envp;  // The environment of the processes with a page.
+    char **placements;  // The placements of the processes, interned.
+    char placement[MAX_PLACEMENT_LENGTH + 1];
+    cpu_set_t cpus;
+    unsigned long nodemask;
+    int place;  // Boolean indicator that the processes are placed.
+    int forked;  // Boolean indicator that the processes are forked.
+    int stats_fd;
+    int output_pipe[2];
+    int redirect;  // Boolean indicator that the output goes to pipes.
+    char process_log_path[MAX_PATH_LENGTH + 1];
+    long *latencies;  // The latency of every spawn in nanoseconds.
+    long *spawn_times;  // The time every spawn started, in nanoseconds.
+    struct timespec start;
+    struct timespec end;
+    int num_spawned;
+    int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
+
+    if ((count <= 0) || (count > MAX_BULK_SPAWNS)) {
+        printf("error, the count of " ANSI_BOLD "exec -n" ANSI_RESET
+                " must be in the range [1, %d]\n", MAX_BULK_SPAWNS);
+        return 0;
+    }
+
+    redirect = options->capture || (options->log_path != NULL);
+
+    pids = (pid_t *)malloc((size_t)count * sizeof(*pids));
+    latencies = (long *)malloc((size_t)count * sizeof(*latencies));
+    spawn_times = (long *)malloc((size_t)count * sizeof(*spawn_times));
+    output_fds = (int *)malloc((size_t)count * sizeof(*output_fds));
+    stats = (scee_stats_t **)malloc((size_t)count * sizeof(*stats));
+    placements = (char **)calloc((size_t)count, sizeof(*placements));
+    if ((pids == NULL) || (latencies == NULL) || (spawn_times == NULL) ||
+            (output_fds == NULL) || (stats == NULL) || (placements == NULL)) {
+        perror("error, malloc");
+        free(pids);
+        free(latencies);
+        free(spawn_times);
+        free(output_fds);
+        free(stats);
+        free(placements);
+        return -1;
+    }
+    place = options->has_cpus || (options->spread != SPREAD_NONE) ||
+            options->membind;
+    forked = (options->job != NULL) || (options->rlimit_as > 0) ||
+            (options->rlimit_cpu > 0) || (options->rlimit_nofile > 0);
+
+    // The children start with the signal mask of scee, without the signals
+    // that child_signal_handling unblocks.
+    sigprocmask(SIG_BLOCK, NULL, &signals_set);
+    sigdelset(&signals_set, SIGTERM);
+    sigdelset(&signals_set, SIGSTOP);
+    sigdelset(&signals_set, SIGCONT);
+    sigdelset(&signals_set, SIGUSR1);
+
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setsigmask(&attributes, &signals_set);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    posix_spawnattr_setflags(&attributes,
+            POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP);
+
+    fflush(stdout);
+
+    // Without it, the processes are spawned without statistics pages.
+    envp = stats_environment();
+
+    num_spawned = 0;
+    for (i = 0; i < count; i++) {
+        posix_spawn_file_actions_init(&file_actions);
+        if (redirect) {
+            return_value = pipe2(output_pipe, O_CLOEXEC);
+            if (return_value == -1) {
+                perror("error, pipe2");
+                posix_spawn_file_actions_destroy(&file_actions);
+                break;
+            }
+            posix_spawn_file_actions_adddup2(&file_actions, output_pipe[1],
+                    STDOUT_FILENO);
+            posix_spawn_file_actions_adddup2(&file_actions, output_pipe[1],
+                    STDERR_FILENO);
+        } else if (terminal_fd != -1) {
+            posix_spawn_file_actions_adddup2(&file_actions, terminal_fd,
+                    STDOUT_FILENO);
+        }
+        stats[num_spawned] = envp != NULL ? stats_create(&stats_fd) : NULL;
+        if (stats[num_spawned] != NULL) {
+            posix_spawn_file_actions_adddup2(&file_actions, stats_fd,
+                    SCEE_STATS_FD);
+        }
+
+        if (place) {
+            return_value = placement_choose(options, &cpus, &nodemask,
+                    placement);
+            if (return_value == -1) {
+                printf("error, there are no CPUs to place the processes on\n");
+            } else {
+                return_value = placement_apply(&cpus, nodemask);
+            }
+            if (return_value == -1) {
+                posix_spawn_file_actions_destroy(&file_actions);
+                if (redirect) {
+                    close(output_pipe[0]);
+                    close(output_pipe[1]);
+                }
+                if (stats[num_spawned] != NULL) {
+                    close(stats_fd);
+                    munmap(stats[num_spawned], SCEE_STATS_SIZE);
+                }
+                break;
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (forked) {
+            return_value = spawn_fork(&pids[num_spawned], arguments,
+                    stats[num_spawned] != NULL ? envp : environ,
+                    redirect ? output_pipe[1] : -1,
+                    stats[num_spawned] != NULL ? stats_fd : -1,
+                    num_spawned > 0 ? pids[0] : 0, &signals_set, options);
+        } else {
+            return_value = posix_spawn(&pids[num_spawned], arguments[0],
+                    &file_actions, &attributes, arguments,
+                    stats[num_spawned] != NULL ? envp : environ);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        posix_spawn_file_actions_destroy(&file_actions);
+        if (redirect) {
+            close(output_pipe[1]);
+            if (return_value != 0) {
+                close(output_pipe[0]);
+            } else {
+                output_fds[num_spawned] = output_pipe[0];
+            }
+        }
+        if (stats[num_spawned] != NULL) {
+            close(stats_fd);
+            if (return_value != 0) {
+                munmap(stats[num_spawned], SCEE_STATS_SIZE);
+            }
+        }
+
+        if (return_value != 0) {
+            // The remaining spawns would fail the same way.
+            printf("error in executing the program: %s\n",
+                    strerror(return_value));
+            break;
+        }
+
+        spawn_times[num_spawned] = start.tv_sec * 1000000000L + start.tv_nsec;
+        latencies[num_spawned] = (end.tv_sec - start.tv_sec) * 1000000000L +
+                (end.tv_nsec - start.tv_nsec);
+        histogram_record(&histograms[OPERATION_POSIX_SPAWN],
+                latencies[num_spawned]);
+        if (place) {
+            placements[num_spawned] = path_intern(placement);
+        }
+        num_spawned++;
+
+        if (num_spawned == 1) {
+            // The rest of the processes join the group of the first.
+            posix_spawnattr_setpgroup(&attributes, pids[0]);
+        }
+    }
+
+    posix_spawnattr_destroy(&attributes);
+    free(envp);
+    if (place) {
+        placement_restore();
+    }
+
+    // Add all the spawned processes to the list at once.
+    return_value = index_reserve(processes->index, num_spawned);
+    if (return_value == -1) {
+        printf("error, index_reserve\n");
+    }
+    for (i = 0; i < num_spawned; i++) {
+        return_value = list_add(processes, (int)pids[i], arguments[0]);
+        if (return_value == -1) {
+            printf("error, list_add\n");
+            if (redirect) {
+                close(output_fds[i]);
+            }
+            if (stats[i] != NULL) {
+                munmap(stats[i], SCEE_STATS_SIZE);
+            }
+            path_release(placements[i]);
+            continue;
+        }
+
+        // list_add places the new node right after the sentinel.
+        processes->next->pgid = (int)pids[0];
+        processes->next->usage.start_time = spawn_times[i];
+        processes->next->stats = stats[i];
+        processes->next->placement = placements[i];
+        if (options->job != NULL) {
+            processes->next->job = options->job;
+            options->job->num_processes++;
+            options->job->num_alive++;
+        }
+        if (options->cpu_limit > 0) {
+            throttle_set(processes->next, options->cpu_limit);
+        }
+        if (redirect) {
+            if (options->log_path != NULL) {
+                snprintf(process_log_path, sizeof(process_log_path), "%s.%d",
+                        options->log_path, (int)pids[i]);
+            }
+            return_value = capture_attach(processes->next, output_fds[i],
+                    options->capture,
+                    options->log_path != NULL ? process_log_path : NULL);
+            if (return_value == -1) {
+                printf("error, capture_attach\n");
+            }
+        }
+    }
+
+    if (num_spawned > 0) {
+        printf("%d processes with PIDs %d to %d were spawned",
+                num_spawned, (int)pids[0], (int)pids[num_spawned - 1]);
+        printf(" in process group %d\n", (int)pids[0]);
+
+        qsort(latencies, (size_t)num_spawned, sizeof(*latencies),
+                compare_longs);
+        printf("spawn latency (us): p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+                latencies[num_spawned * 50 / 100] / 1000.0,
+                latencies[num_spawned * 90 / 100] / 1000.0,
+                latencies[num_spawned * 99 / 100] / 1000.0,
+                latencies[num_spawned - 1] / 1000.0);
+    }
+
+    // Memory deallocation.
+    free(pids);
+    free(latencies);
+    free(spawn_times);
+    free(output_fds);
+    free(stats);
+    free(placements);
+
+    // Remove the job if no process could be spawned.
+    if ((options->job != NULL) && (options->job->num_processes == 0)) {
+        job_collect();
+    }
+
+    return 0;
+}
+
+int low_level_process_kill(process_t *process) {
+    // Description
+    // This function kills the process process and removes its node from
+    // the list it resides.
+    //
+    // Returns
+    // low_level_process_kill returns 0 on successful completion
+    // or -1 in case of failure.
+
+    // variable declaration
+    int return_value;  // integer placeholder for error checking
+
+    // kill the process, unless it has already exited.
+    if (!process->exited) {
+        return_value = send_signal(process->pid, SIGTERM);
+        if (return_value == -1) {
+            perror("error, kill");
+            return -1;
+        }
+    }
+
+    // TODO
+    // I would like a check here of whether the process exists after several
+    // specified periods of time. If it does, it could be killed with
+    // kill((pid_t)process->pid, SIGKILL);
+
+    // Remove its node from the list.
+    return_value = list_remove(process);
+    if (return_value == -1) {
+        printf("error, list_remove\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int selection_add(selection_t *selection, process_t *node) {
+    // Description
+    // This function appends the node node to the selection selection,
+    // growing its array if needed.
+    //
+    // Returns
+    // selection_add returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    int capacity;
+    void *return_pointer;  // pointer placeholder for error checking
+
+    if (selection->num_nodes == selection->capacity) {
+        capacity = selection->capacity > 0 ? 2 * selection->capacity : 64;
+        return_pointer = (process_t **)realloc(selection->nodes,
+                (size_t)capacity * sizeof(*selection->nodes));
+        if (return_pointer == NULL) {
+            perror("error, realloc");
+            return -1;
+        }
+        selection->nodes = return_pointer;
+        return_pointer = (int *)realloc(selection->results,
+                (size_t)capacity * sizeof(*selection->results));
+        if (return_pointer == NULL) {
+            perror("error, realloc");
+            return -1;
+        }
+        selection->results = return_pointer;
+        selection->capacity = capacity;
+    }
+
+    selection->nodes[selection->num_nodes] = node;
+    selection->num_nodes++;
+
+    return 0;
+}
+
+int compare_pointers(const void *a, const void *b) {
+    // Description
+    // This function compares the pointers pointed to by a and b, for use with
+    // qsort.
+    //
+    // Returns
+    // compare_pointers returns a negative value, 0, or a positive value, if a
+    // is less than, equal to, or greater than b, respectively.
+
+    // variable declaration
+    uintptr_t x = (uintptr_t)*(void * const *)a;
+    uintptr_t y = (uintptr_t)*(void * const *)b;
+
+    return (x > y) - (x < y);
+}
+
+int process_select(process_t *processes, char *arguments[],
+        selection_t *selection) {
+    // Description
+    // This function stores in selection the nodes of processes that match
+    // the selector given in arguments. The selector is one of
+    //     all, every process,
+    //     --path PATH, the processes of the executable file PATH,
+    //     --group PGID, the processes of the process group PGID,
+    //     a comma separated list of PIDs and PID ranges, such as 10,20-30.
+    // PIDs are looked up in the PID index, the other selectors and the PID
+    // ranges wider than the list take a single pass over the list. Exited
+    // processes are not selected.
+    //
+    // Returns
+    // process_select returns the number of nodes selected or -1 in case of
+    // failure, or if the selector is invalid.
+
+    // variable declaration
+    process_t *node;
+    char *element;
+    char *end;
+    long first;
+    long last;
+    long pid;
+    int i, j;  // generic counters
+
+    selection->num_nodes = 0;
+    selection->pgid = 0;
+
+    if (arguments[0] == NULL) {
+        return -1;
+    }
+
+    if (!strcmp(arguments[0], "all") || !strcmp(arguments[0], "--path") ||
+            !strcmp(arguments[0], "--group")) {
+        if (!strcmp(arguments[0], "--group")) {
+            if (arguments[1] == NULL) {
+                return -1;
+            }
+            selection->pgid = atoi(arguments[1]);
+            if (selection->pgid <= 0) {
+                return -1;
+            }
+        } else if (!strcmp(arguments[0], "--path") && (arguments[1] == NULL)) {
+            return -1;
+        }
+
+        for (node = processes->next; node != processes; node = node->next) {
+            if (node->exited) {
+                continue;
+            }
+            if (!strcmp(arguments[0], "--path") &&
+                    strcmp(node->path, arguments[1])) {
+                continue;
+            }
+            if ((selection->pgid != 0) && (node->pgid != selection->pgid)) {
+                continue;
+            }
+            if (selection_add(selection, node) == -1) {
+                return -1;
+            }
+        }
+
+        return selection->num_nodes;
+    }
+
+    // A list of PIDs and PID ranges.
+    element = arguments[0];
+    while (*element != '\0') {
+        first = strtol(element, &end, 10);
+        if ((end == element) || (first <= 0)) {
+            return -1;
+        }
+        last = first;
+        if (*end == '-') {
+            element = end + 1;
+            last = strtol(element, &end, 10);
+            if ((end == element) || (last < first)) {
+                return -1;
+            }
+        }
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        element = end;
+
+        // A range wider than the number of processes takes a pass over
+        // the list instead, so that its length doesn't matter.
+        if (last - first >= processes->index->length) {
+            for (node = processes->next; node != processes; node = node->next) {
+                if ((node->pid >= first) && (node->pid <= last) &&
+                        !node->exited) {
+                    if (selection_add(selection, node) == -1) {
+                        return -1;
+                    }
+                }
+            }
+            continue;
+        }
+
+        for (pid = first; pid <= last; pid++) {
+            node = index_search(processes->index, (int)pid);
+            if ((node != NULL) && !node->exited) {
+                if (selection_add(selection, node) == -1) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // Drop the duplicates of overlapping ranges.
+    qsort(selection->nodes, (size_t)selection->num_nodes,
+            sizeof(*selection->nodes), compare_pointers);
+    j = 0;
+    for (i = 0; i < selection->num_nodes; i++) {
+        if ((j == 0) || (selection->nodes[i] != selection->nodes[j - 1])) {
+            selection->nodes[j] = selection->nodes[i];
+            j++;
+        }
+    }
+    selection->num_nodes = j;
+
+    return selection->num_nodes;
+}
+
+int process_signal(process_t *processes, char *arguments[], int signal_number,
+        const char *action) {
+    // Description
+    // This function sends the signal signal_number, one of SIGTERM, SIGSTOP,
+    // and SIGCONT, to the processes selected by process_select from
+    // arguments, and updates their nodes in a single pass: stopped processes
+    // are marked as stopped, resumed processes as running, and terminated
+    // processes are removed. A process group is signalled with a single
+    // killpg, and whole jobs are stopped and resumed with jobs_freeze.
+    // action is the past participle of the command, for the report.
+    //
+    // Returns
+    // process_signal returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    static selection_t selection;  // reused, so it rarely has to grow
+    process_t *node;
+    int num_selected;
+    int num_signalled;
+    int num_frozen;  // The processes stopped or resumed by their cgroups.
+    int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
+
+    return_value = process_select(processes, arguments, &selection);
+    if (return_value == -1) {
+        printf("error, invalid selector; use a PID, a list of PIDs and PID"
+                " ranges, all, --path PATH, or --group PGID\n");
+        return 0;
+    }
+
+    if ((selection.pgid != 0) && (selection.num_nodes == 0)) {
+        printf("no processes in process group %d\n", selection.pgid);
+        return 0;
+    }
+
+    // Whole jobs are stopped and resumed through their cgroups, the rest of
+    // the processes one by one.
+    num_frozen = 0;
+    if ((signal_number == SIGSTOP) || (signal_number == SIGCONT)) {
+        num_frozen = jobs_freeze(&selection, signal_number == SIGSTOP);
+        if (num_frozen > 0) {
+            selection.pgid = 0;
+        }
+    }
+
+    if (selection.pgid != 0) {
+        // kill signals the whole group given its negated PGID, like killpg.
+        return_value = send_signal(-selection.pgid, signal_number);
+        if (return_value == -1) {
+            perror("error, killpg");
+            return -1;
+        }
+    }
+
+    // Skip the processes already in the requested state, unless the whole
+    // group has been signalled anyway.
+    num_selected = 0;
+    for (i = 0; i < selection.num_nodes; i++) {
+        node = selection.nodes[i];
+        if ((selection.pgid == 0) &&
+                (((signal_number == SIGSTOP) && node->stopped) ||
+                ((signal_number == SIGCONT) && !node->stopped))) {
+            continue;
+        }
+        // The processes stopped by the user aren't time-sliced until they
+        // are resumed, and the scheduler must not resume them meanwhile.
+        if (signal_number == SIGSTOP) {
+            sched_detach(node, 0);
+            throttle_detach(node, 0);
+        }
+        selection.nodes[num_selected] = node;
+        selection.results[num_selected] = 0;
+        num_selected++;
+    }
+    selection.num_nodes = num_selected;
+
+    // Signal the processes one by one.
+    if (selection.pgid == 0) {
+        signal_batch(selection.nodes, selection.num_nodes, signal_number,
+                selection.results);
+    }
+
+    num_signalled = 0;
+    for (i = 0; i < selection.num_nodes; i++) {
+        node = selection.nodes[i];
+        if (selection.results[i] != 0) {
+            printf("error, kill: %s\n", strerror(selection.results[i]));
+            continue;
+        }
+
+        if (signal_number == SIGTERM) {
+            list_remove(node);
+        } else if (signal_number == SIGSTOP) {
+            node->stopped = 1;
+        } else {
+            node->stopped = 0;
+            sched_attach(node);
+            throttle_attach(node);
+        }
+        num_signalled++;
+    }
+
+    num_signalled += num_frozen;
+    if (num_signalled == 1) {
+        printf("1 process was %s", action);
+    } else {
+        printf("%d processes were %s", num_signalled, action);
+    }
+    if (num_frozen > 0) {
+        printf(", %d through cgroup.freeze", num_frozen);
+    }
+    printf("\n");
+
+    return 0;
+}
+
+int process_kill(process_t *processes, char *arguments[]) {
+    // Description
+    // This function kills the process with PID equal to the first element of
+    // arguments, provided it exists in the list processes, and removes its
+    // node from it. Other selectors are handled by process_signal.
+    //
+    // Returns
+    // process_kill returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    char *string_pid;  // the first element of arguments
+    int pid;
+    process_t *result;
+    int return_value;  // integer placeholder for error checking
+
+    // process_kill requires a valid PID.
+    string_pid = arguments[0];
+    if (string_pid == NULL) {
+        printf("error, " ANSI_BOLD "kill" ANSI_RESET " requires a valid PID\n");
+        return 0;
+    }
+
+    // Anything other than a single PID selects several processes.
+    if (strspn(string_pid, "0123456789") != strlen(string_pid)) {
+        return process_signal(processes, arguments, SIGTERM, "killed");
+    }
+
+    // Store the PID as an integer.
+    pid = atoi(string_pid);
+
+    // Search in list processes for a process with PID equal to pid.
+    return_value = list_search(processes, &result, pid);
+    if (return_value == -1) {
+        printf("error, list_search\n");
+        return -1;
+    } else if (return_value == 0) {
+        printf("no process with PID %d\n", pid);
+    } else if (result->exited) {
+        list_remove(result);
+        printf("the process with PID %d had already exited\n", pid);
+    } else {
+        return_value = low_level_process_kill(result);
+        if (return_value == -1) {
+            printf("error, low_level_process_kill\n");
+            return -1;
+        } else {
+            printf("the process with PID %d was killed\n", pid);
+        }
+    }
+
+    return 0;
+}
+
+int process_stop(process_t *processes, char *arguments[]) {
+    // Description
+    // This function stops the process with PID equal to the first element of
+    // arguments, provided it exists in the list processes and isn't already
+    // stopped, and sets its stopped status to 1. Other selectors are handled
+    // by process_signal.
+    //
+    // Returns
+    // process_stop returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    char *string_pid;  // the first element of arguments
+    int pid;
+    process_t *result;
+    process_t *process;
+    int return_value;  // integer placeholder for error checking
+
+    // process_stop requires a valid PID.
+    string_pid = arguments[0];
+    if (string_pid == NULL) {
+        printf("error, " ANSI_BOLD "stop" ANSI_RESET " requires a valid PID\n");
+        return 0;
+    }
+
+    // Anything other than a single PID selects several processes.
+    if (strspn(string_pid, "0123456789") != strlen(string_pid)) {
+        return process_signal(processes, arguments, SIGSTOP, "stopped");
+    }
+
+    // Store the PID as an integer.
+    pid = atoi(string_pid);
+
+    // Search in list processes for a process with PID equal to pid.
+    return_value = list_search(processes, &result, pid);
+    if (return_value == -1) {
+        printf("error, list_search\n");
+        return -1;
+    } else if (return_value == 0) {
+        printf("no process with PID %d\n", pid);
+    } else if (result->exited) {
+        printf("the process with PID %d has exited\n", pid);
+    } else {
+        process = result;
+        if (!(process->stopped)) {
+            // Stop the process, which the scheduler and the throttler leave
+            // alone until it is resumed.
+            sched_detach(process, 0);
+            throttle_detach(process, 0);
+            return_value = send_signal(pid, SIGSTOP);
+            if (return_value == -1) {
+                perror("error, kill");
+                return -1;
+            }
+
+            // Set the stopped status of the process node to 1.
+            process->stopped = 1;
+
+            printf("the process with PID %d was stopped\n", pid);
+        } else {
+            printf("the process with PID %d is already stopped\n", pid);
+        }
+    }
+
+    return 0;
+}
+
+int process_cont(process_t *processes, char *arguments[]) {
+    // Description
+    // This function resumes the process with PID equal to the first element
+    // of arguments, provided it exists in the list processes and isn't already
+    // running, and sets its stopped status to 0. Other selectors are handled
+    // by process_signal.
+    //
+    // Returns
+    // process_cont returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    char *string_pid;  // the first element of arguments
+    int pid;
+    process_t *result;
+    process_t *process;
+    int return_value;  // integer placeholder for error checking
+
+    // process_cont requires a valid PID.
+    string_pid = arguments[0];
+    if (string_pid == NULL) {
+        printf("error, " ANSI_BOLD "cont" ANSI_RESET " requires a valid PID\n");
+        return 0;
+    }
+
+    // Anything other than a single PID selects several processes.
+    if (strspn(string_pid, "0123456789") != strlen(string_pid)) {
+        return process_signal(processes, arguments, SIGCONT, "resumed");
+    }
+
+    // Store the PID as an integer.
+    pid = atoi(string_pid);
+
+    // Search in list processes for a process with PID equal to pid.
+    return_value = list_search(processes, &result, pid);
+    if (return_value == -1) {
+        printf("error, list_search\n");
+        return -1;
+    } else if (return_value == 0) {
+        printf("no process with PID %d\n", pid);
+    } else if (result->exited) {
+        printf("the process with PID %d has exited\n", pid);
+    } else {
+        process = result;
+        if (process->stopped) {
+            // Resume the process, after splitting its job if it is frozen.
+            if ((process->job != NULL) && process->job->frozen) {
+                job_split(process->job, process);
+            }
+            return_value = send_signal(pid, SIGCONT);
+            if (return_value == -1) {
+                perror("error, kill");
+                return -1;
+            }
+
+            // Set the stopped status of the process node to 0.
+            process->stopped = 0;
+            sched_attach(process);
+            throttle_attach(process);
+
+            printf("the process with PID %d was resumed\n", pid);
+        } else {
+            printf("the process with PID %d is already running\n", pid);
+        }
+    }
+
+    return 0;
+}
+
+void format_status(char *status, const process_t *process) {
+    // Description
+    // This function stores in status a short description of the state of
+    // the process process, at most MAX_STATUS_LENGTH characters long.
+    //
+    // Returns
+    // format_status does not return any value.
+
+    if (!process->exited) {
+        strcpy(status, !process->stopped ? "running" :
+                ((process->job != NULL) && process->job->frozen) ? "frozen" :
+                "stopped");
+    } else if (WIFSIGNALED(process->exit_status)) {
+        snprintf(status, MAX_STATUS_LENGTH + 1, "sig %d",
+                WTERMSIG(process->exit_status));
+    } else {
+        snprintf(status, MAX_STATUS_LENGTH + 1, "exit %d",
+                WEXITSTATUS(process->exit_status));
+    }
+}
+
+int process_list(process_t *list, char *arguments[]) {
+    // Description
+    // This function prints a table with information about the spawned
+    // processes. It contains the processes PID, their status, and the path
+    // used to execute the program, followed by the rate at which the output
+    // is logged for the processes spawned with exec --log, and where exec
+    // placed the processes spawned with a placement. The processes that have
+    // exited since the last listing are shown with their exit status, and
+    // their entries are subsequently removed. The exits are detected by
+    // process_reap, so no system calls are made per entry.
+    //
+    // The options "--offset M" and "--limit N" in arguments restrict the table
+    // to N rows, starting after the first M entries, so that large tables can
+    // be paged. The rows outside of the page are not formatted.
+    //
+    // The table is rendered in a buffer that is written at once. It is
+    // followed by the memory used per tracked process and, on its own line,
+    // by how full the chunks of the node pool are, on which the memory per
+    // process depends.
+    //
+    // Returns
+    // process_list returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    static buffer_t buffer;  // reused, so it rarely has to grow
+    process_t *node;
+    process_t *next;
+    process_t *first;  // the first node of the page
+    char status[MAX_STATUS_LENGTH + 1];
+    int offset;
+    int limit;
+    int num_rows;
+    int num_removed;  // The number of exited entries removed from the list.
+    long now;
+    const char border[] = "+-------+----------+"
+            "------------------------------------------------------------\n";
+
+    if (list == NULL) {
+        // list should point to a valid list.
+        return -1;
+    }
+
+    offset = parse_option(arguments, "--offset", 0);
+    limit = parse_option(arguments, "--limit", list->index->length);
+    if ((offset < 0) || (limit < 0)) {
+        printf("error, " ANSI_BOLD "list" ANSI_RESET
+                " requires a non negative offset and limit\n");
+        return 0;
+    }
+
+    buffer_printf(&buffer, "\n"
+            "+-------------------"
+            "------------------------------------------------------------\n"
+            "|  spawned processes\n"
+            "%s"
+            "|  PID  |  status  |  path  \n"
+            "%s", border, border);
+
+    // Skip the entries before the page.
+    for (first = list->next; (first != list) && (offset > 0);
+            first = first->next) {
+        offset--;
+    }
+
+    if (first == list) {
+        // empty entry
+        buffer_printf(&buffer, "|       |          |        \n");
+    }
+
+    // process data
+    now = monotonic_nanoseconds();
+    num_rows = 0;
+    for (node = first; (node != list) && (num_rows < limit);
+            node = node->next) {
+        format_status(status, node);
+        buffer_printf(&buffer, "| %5d |  %-7s | %s", node->pid, status,
+                node->path);
+        if ((node->capture != NULL) && (node->capture->log_path != NULL)) {
+            buffer_printf(&buffer, "  [log %.1f KiB/s]",
+                    log_rate(node->capture, now) / 1024.0);
+        }
+        if (node->placement != NULL) {
+            buffer_printf(&buffer, "  [%s]", node->placement);
+        }
+        buffer_printf(&buffer, " \n");
+        num_rows++;
+    }
+
+    // bottom border
+    buffer_printf(&buffer, "%s", border);
+
+    if (num_rows < list->index->length) {
+        buffer_printf(&buffer, "%d of %d entries shown\n", num_rows,
+                list->index->length);
+    }
+
+    // Remove the entries of the exited processes that were shown.
+    num_removed = 0;
+    for (node = first; num_rows > 0; node = next) {
+        next = node->next;
+        if (node->exited) {
+            list_remove(node);
+            num_removed++;
+        }
+        num_rows--;
+    }
+
+    if (num_removed == 1) {
+        buffer_printf(&buffer, "\n1 exited process entry was removed\n\n");
+    } else if (num_removed > 1) {
+        buffer_printf(&buffer, "\n%d exited process entries were removed\n\n",
+                num_removed);
+    }
+
+    if (list->index->count > 0) {
+        buffer_printf(&buffer, "%d processes tracked, %ld bytes per process\n",
+                list->index->count,
+                memory_usage(list) / list->index->count);
+        buffer_printf(&buffer, "node pool: %d of %d nodes of %zu bytes in use,"
+                " %d %s of %d nodes allocated\n", pool.num_used,
+                pool.num_chunks * POOL_CHUNK_SIZE, sizeof(process_t),
+                pool.num_chunks, pool.num_chunks == 1 ? "chunk" : "chunks",
+                POOL_CHUNK_SIZE);
+    }
+
+    return buffer_write(&buffer, STDOUT_FILENO);
+}
+
+int catches_signal(int pid, int signal_number) {
+    // Description
+    // This function checks in /proc/<pid>/status whether the process with PID
+    // pid has installed a handler for the signal signal_number, so that
+    // signals that would terminate it aren't sent.
+    //
+    // Returns
+    // catches_signal returns 1 if the signal is caught, 0 if it isn't, or -1
+    // in case of failure.
+
+    // variable declaration
+    char status[4096];  // /proc/<pid>/status is longer than the other files
+    const char *line;
+    unsigned long long caught;
+    int return_value;  // integer placeholder for error checking
+
+    return_value = read_proc_file(pid, "status", status, sizeof(status));
+    if (return_value == -1) {
+        return -1;
+    }
+
+    line = strstr(status, "\nSigCgt:");
+    if (line == NULL) {
+        return -1;
+    }
+    caught = strtoull(line + strlen("\nSigCgt:"), NULL, 16);
+
+    return (caught >> (signal_number - 1)) & 1;
+}
+
+int compare_requests(const void *a, const void *b) {
+    // Description
+    // This function compares the info requests pointed to by a and b by PID,
+    // for use with qsort and bsearch.
+    //
+    // Returns
+    // compare_requests returns a negative value, zero, or a positive value if
+    // the PID of a is less than, equal to, or greater than the PID of b.
+
+    // variable declaration
+    const info_request_t *first = a;
+    const info_request_t *second = b;
+
+    return (first->pid > second->pid) - (first->pid < second->pid);
+}
+
+int info_match(info_request_t *requests, int num_requests,
+        const struct signalfd_siginfo *siginfo, int num_signals) {
+    // Description
+    // This function matches the num_signals replies of siginfo to the
+    // requests of requests, sorted by PID, that are waiting for a reply, by
+    // the PID of their sender, and records them with the time elapsed since
+    // SIGUSR1 was sent to each of them. Replies that match no pending
+    // request, left over from an earlier timeout, are ignored.
+    //
+    // Returns
+    // info_match returns the number of requests replied to.
+
+    // variable declaration
+    info_request_t key;
+    info_request_t *request;
+    long now;
+    int num_replies;
+    int i;  // generic counter
+
+    now = monotonic_nanoseconds();
+    num_replies = 0;
+    for (i = 0; i < num_signals; i++) {
+        key.pid = (int)siginfo[i].ssi_pid;
+        request = bsearch(&key, requests, (size_t)num_requests,
+                sizeof(*requests), compare_requests);
+        if ((request == NULL) || (request->source != INFO_PENDING)) {
+            continue;
+        }
+
+        request->source = INFO_SIGNAL;
+        request->counter = SCEE_INFO_COUNTER(siginfo[i].ssi_int);
+        request->delay = SCEE_INFO_DELAY(siginfo[i].ssi_int);
+        request->latency = now - request->send_time;
+        num_replies++;
+    }
+
+    return num_replies;
+}
+
+int info_collect(info_request_t *requests, int num_requests, int num_pending) {
+    // Description
+    // This function collects through info_fd the replies to the num_pending
+    // requests of requests, sorted by PID, that are waiting for a reply, for
+    // at most INFO_TIMEOUT_MILLISECONDS. Every reply is matched to its
+    // request with info_match.
+    //
+    // Returns
+    // info_collect returns the number of replies collected or -1 in case of
+    // failure.
+
+    // variable declaration
+    struct signalfd_siginfo siginfo[64];
+    struct pollfd poll_fd;
+    struct timespec start;
+    long elapsed;
+    int timeout;
+    int num_replies;
+    ssize_t num_read;
+    int return_value;  // integer placeholder for error checking
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    poll_fd.fd = info_fd;
+    poll_fd.events = POLLIN;
+
+    num_replies = 0;
+    while (num_replies < num_pending) {
+        elapsed = elapsed_nanoseconds(&start);
+        timeout = INFO_TIMEOUT_MILLISECONDS - (int)(elapsed / 1000000);
+        if (timeout <= 0) {
+            break;
+        }
+
+        return_value = poll(&poll_fd, 1, timeout);
+        if (return_value == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("error, poll");
+            return -1;
+        } else if (return_value == 0) {
+            break;
+        }
+
+        num_read = read(info_fd, siginfo, sizeof(siginfo));
+        if (num_read == -1) {
+            if (errno == EAGAIN) {
+                continue;
+            }
+            perror("error, read");
+            return -1;
+        }
+
+        num_replies += info_match(requests, num_requests, siginfo,
+                (int)(num_read / (ssize_t)sizeof(siginfo[0])));
+    }
+
+    return num_replies;
+}
+
+int info_report(process_t *processes, const info_request_t *requests,
+        int num_requests, int all) {
+    // Description
+    // This function prints the information of the num_requests requests of
+    // requests, as a table if all is set. A single process of the list
+    // processes, if it is still running, also has the CPU and NUMA node it
+    // last ran on, and the CPUs it may run on, printed.
+    //
+    // Returns
+    // info_report returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    buffer_t buffer = { NULL, 0, 0 };
+    const info_request_t *request;
+    process_t *result;
+    cpu_set_t cpus;  // The CPUs the process may run on.
+    char cpu_list[256];
+    int cpu;  // The CPU the process last ran on.
+    int node_id;  // The NUMA node of the CPU.
+    int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
+
+    if (all) {
+        buffer_printf(&buffer, "\n%7s %9s %6s %10s  %-8s %s\n", "PID",
+                "outputs", "delay", "time (us)", "source", "path");
+    }
+    for (i = 0; i < num_requests; i++) {
+        request = &requests[i];
+        if (all && ((request->source == INFO_SHARED) ||
+                (request->source == INFO_SIGNAL))) {
+            buffer_printf(&buffer, "%7d %9ld %5lds %10.2f  %-8s %s\n",
+                    request->pid, request->counter, request->delay,
+                    request->latency / 1000.0,
+                    request->source == INFO_SHARED ? "shared" : "signal",
+                    request->path);
+        } else if (all) {
+            buffer_printf(&buffer, "%7d %9s %6s %10s  %-8s %s\n", request->pid,
+                    "-", "-", "-",
+                    request->source == INFO_STOPPED ? "stopped" :
+                    request->source == INFO_PENDING ? "timeout" : "none",
+                    request->path);
+        } else if ((request->source == INFO_SHARED) ||
+                (request->source == INFO_SIGNAL)) {
+            buffer_printf(&buffer, "PID %d: %ld outputs so far, delay %ld s"
+                    " (%s in %.2f us)\n", request->pid, request->counter,
+                    request->delay,
+                    request->source == INFO_SHARED ?
+                    "read from shared memory" : "replied to SIGUSR1",
+                    request->latency / 1000.0);
+        } else if (request->source == INFO_STOPPED) {
+            buffer_printf(&buffer, "the process with PID %d is stopped\n",
+                    request->pid);
+        } else if (request->source == INFO_PENDING) {
+            buffer_printf(&buffer, "the process with PID %d didn't reply"
+                    " within %d ms\n", request->pid, INFO_TIMEOUT_MILLISECONDS);
+        } else {
+            buffer_printf(&buffer, "the process with PID %d doesn't report"
+                    " information\n", request->pid);
+        }
+    }
+
+    if (!all && (num_requests == 1) &&
+            (list_search(processes, &result, requests[0].pid) == 1) &&
+            !result->exited) {
+        node_id = placement_current(result->pid, &cpu);
+        if ((node_id != -1) && (sched_getaffinity(result->pid,
+                sizeof(cpu_set_t), &cpus) == 0)) {
+            cpuset_format(&cpus, cpu_list, sizeof(cpu_list));
+            buffer_printf(&buffer, "PID %d: last ran on CPU %d of node %d, "
+                    "may run on CPUs %s", result->pid, cpu, node_id,
+                    cpu_list);
+            if (result->placement != NULL) {
+                buffer_printf(&buffer, " (placed on %s)", result->placement);
+            }
+            buffer_printf(&buffer, "\n");
+        }
+    }
+
+    fflush(stdout);
+    return_value = buffer_write(&buffer, STDOUT_FILENO);
+
+    // Memory deallocation.
+    free(buffer.data);
+
+    return return_value;
+}
+
+int process_info(process_t *processes, char *arguments[]) {
+    // Description
+    // This function prints information about the process with PID equal to
+    // the first element of arguments, provided it exists in the list
+    // processes, or about every running process if it is "all".
+    //
+    // The counters of a process are read directly from the statistics page
+    // shared with it, without signalling it. The processes that don't
+    // publish their statistics, but catch SIGUSR1, are sent SIGUSR1 instead,
+    // all at once, and their replies are collected with info_collect, or
+    // by the server loop in daemon mode, so that the other clients are
+    // served in the meantime. The information is printed by info_report.
+    //
+    // Returns
+    // process_info returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    info_request_t *requests;
+    info_request_t *request;
+    struct signalfd_siginfo siginfo[64];
+    scee_stats_t stats;
+    struct timespec start;
+    process_t *node;
+    process_t *result;
+    int num_requests;
+    int num_pending;
+    int all;  // Boolean indicator that every process is requested.
+    int pid;
+    int return_value;  // integer placeholder for error checking
+
+    // process_info requires a valid PID.
+    if (arguments[0] == NULL) {
+        printf("error, " ANSI_BOLD "info" ANSI_RESET " requires a valid PID\n");
+        return 0;
+    }
+
+    all = !strcmp(arguments[0], "all");
+    if (!all) {
+        pid = atoi(arguments[0]);
+
+        // Search in list processes for a process with PID equal to pid.
+        return_value = list_search(processes, &result, pid);
+        if (return_value == -1) {
+            printf("error, list_search\n");
+            return -1;
+        } else if (return_value == 0) {
+            printf("no process with PID %d\n", pid);
+            return 0;
+        } else if (result->exited) {
+            printf("the process with PID %d has exited\n", pid);
+            return 0;
+        }
+    }
+
+    // An empty table has nothing to request, and malloc may return NULL for
+    // a size of 0.
+    if (all && (processes->index->count == 0)) {
+        return info_report(processes, NULL, 0, all);
+    }
+
+    requests = (info_request_t *)malloc(
+            (size_t)(all ? processes->index->count : 1) * sizeof(*requests));
+    if (requests == NULL) {
+        perror("error, malloc");
+        return -1;
+    }
+
+    // Discard the late replies to earlier requests, unless the server loop
+    // is waiting for replies.
+    if (server.info_waits == NULL) {
+        while (read(info_fd, siginfo, sizeof(siginfo)) > 0);
+    }
+
+    // Read the statistics pages, and send SIGUSR1 to the other processes.
+    num_requests = 0;
+    num_pending = 0;
+    for (node = all ? processes->next : result; node != processes;
+            node = all ? node->next : processes) {
+        if (node->exited) {
+            continue;
+        }
+
+        request = &requests[num_requests];
+        num_requests++;
+        request->pid = node->pid;
+        request->path = node->path;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if ((node->stats != NULL) && (stats_read(node->stats, &stats) == 0)) {
+            request->source = INFO_SHARED;
+            request->counter = stats.counter;
+            request->delay = stats.delay;
+            request->latency = elapsed_nanoseconds(&start);
+        } else if (node->stopped) {
+            request->source = INFO_STOPPED;
+        } else if (catches_signal(node->pid, SIGUSR1) != 1) {
+            request->source = INFO_UNAVAILABLE;
+        } else {
+            // The latency of a reply is counted from its own request, not
+            // from the first one.
+            request->send_time = monotonic_nanoseconds();
+            if (send_signal(node->pid, SIGUSR1) == -1) {
+                perror("error, kill");
+                request->source = INFO_UNAVAILABLE;
+            } else {
+                request->source = INFO_PENDING;
+                num_pending++;
+            }
+        }
+    }
+    qsort(requests, (size_t)num_requests, sizeof(*requests), compare_requests);
+
+    // In daemon mode the replies are collected by the server loop, which
+    // reports them and takes care of requests.
+    if ((num_pending > 0) && (server.current != NULL) &&
+            (server_wait_info(requests, num_requests, num_pending, all) == 0)) {
+        return 0;
+    }
+
+    // Collect the replies to SIGUSR1 in a single pass.
+    if (num_pending > 0) {
+        return_value = info_collect(requests, num_requests, num_pending);
+        if (return_value == -1) {
+            printf("error, info_collect\n");
+        }
+    }
+
+    return_value = info_report(processes, requests, num_requests, all);
+
+    // Memory deallocation.
+    free(requests);
+
+    return return_value;
+}
+
+int quit_start(process_t *list) {
+    // Description
+    // This function starts the termination of all the spawned processes of
+    // the list list that are still running, for quit. SIGTERM is sent to all
+    // the processes first, followed by SIGCONT for the stopped ones, so that
+    // they can handle it, both with signal_batch. The processes to be reaped
+    // are counted in quitting.
+    //
+    // Returns
+    // quit_start returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    static selection_t selection;  // the processes to signal
+    process_t *node;
+    int num_stopped;  // the number of stopped processes to resume
+    int i;  // generic counter
+
+    clock_gettime(CLOCK_MONOTONIC, &quitting.start);
+    quitting.active = 1;
+    quitting.num_running = 0;
+    quitting.num_terminated = 0;
+
+    // Resume the processes stopped by the scheduler and the throttler.
+    sched_disable();
+    throttle_clear();
+
+    // Signal all the processes, then resume the stopped ones. A failure
+    // means that the process has exited, it will be reaped.
+    selection.num_nodes = 0;
+    for (node = list->next; node != list; node = node->next) {
+        if (!node->exited && (selection_add(&selection, node) == -1)) {
+            return -1;
+        }
+    }
+    signal_batch(selection.nodes, selection.num_nodes, SIGTERM,
+            selection.results);
+    num_stopped = 0;
+    for (i = 0; i < selection.num_nodes; i++) {
+        if (selection.results[i] != 0) {
+            continue;
+        }
+        quitting.num_running++;
+        if (selection.nodes[i]->stopped) {
+            selection.nodes[i]->stopped = 0;
+            selection.nodes[num_stopped++] = selection.nodes[i];
+        }
+    }
+    signal_batch(selection.nodes, num_stopped, SIGCONT, selection.results);
+    jobs_thaw();
+    quitting.num_terminated = quitting.num_running;
+
+    return 0;
+}
+
+int quit_finish(process_t *list) {
+    // Description
+    // This function completes the termination started by quit_start. The
+    // processes of the list list still running are killed with SIGKILL and
+    // reaped, all the entries are removed, and the total shutdown time is
+    // printed.
+    //
+    // Returns
+    // quit_finish returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    static selection_t selection;  // the processes to kill
+    process_t *node;
+    int num_killed;  // the number of processes killed with SIGKILL
+    int status;
+    int return_value;  // integer placeholder for error checking
+
+    quitting.active = 0;
+
+    // Kill the remaining processes.
+    num_killed = 0;
+    selection.num_nodes = 0;
+    for (node = list->next; node != list; node = node->next) {
+        if (!node->exited && (selection_add(&selection, node) == -1)) {
+            return -1;
+        }
+    }
+    signal_batch(selection.nodes, selection.num_nodes, SIGKILL,
+            selection.results);
+    for (node = list->next; node != list; node = node->next) {
+        if (!node->exited) {
+            return_value = waitpid((pid_t)node->pid, &status, 0);
+            if (return_value != -1) {
+                node->exited = 1;
+                node->exit_status = status;
+                if (WIFSIGNALED(status) && (WTERMSIG(status) == SIGKILL)) {
+                    num_killed++;
+                }
+            }
+        }
+    }
+
+    // Remove all the entries, and the cgroups of their jobs.
+    while (list->next != list) {
+        list_remove(list->next);
+    }
+    job_collect();
+    cgroup_stop();
+
+    printf("%d processes terminated in %.3f ms", quitting.num_terminated,
+            elapsed_nanoseconds(&quitting.start) / 1e6);
+    if (num_killed > 0) {
+        printf(", %d of them killed with SIGKILL", num_killed);
+    }
+    printf("\n");
+
+    return 0;
+}
+
+int process_quit(process_t *list, char *arguments[]) {
+    // Description
+    // This function terminates all spawned processes that are still running.
+    // It takes no arguments.
+    //
+    // The processes are signalled by quit_start, then reaped through
+    // sigchld_fd as they exit, until QUIT_TIMEOUT_MILLISECONDS have passed,
+    // and the ones still running at that point are killed by quit_finish.
+    // In daemon mode the processes are reaped by the server loop instead,
+    // which goes on serving the other clients until quit_finish is called.
+    //
+    // Returns
+    // process_quit returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    struct pollfd poll_fd;
+    long remaining;  // milliseconds remaining until the deadline
+    int return_value;  // integer placeholder for error checking
+
+    (void)arguments;
+
+    if (quitting.active) {
+        printf("scee is already quitting\n");
+        return 0;
+    }
+
+    return_value = quit_start(list);
+    if (return_value == -1) {
+        quitting.active = 0;
+        return -1;
+    }
+    if ((quitting.num_running > 0) && (sigchld_fd != -1) &&
+            (server.current != NULL) && (server_wait_quit() == 0)) {
+        return 0;
+    }
+
+    // Reap the processes as they exit, until the deadline.
+    poll_fd.fd = sigchld_fd;
+    poll_fd.events = POLLIN;
+    while (quitting.num_running > 0) {
+        remaining = QUIT_TIMEOUT_MILLISECONDS -
+                elapsed_nanoseconds(&quitting.start) / 1000000;
+        if ((remaining <= 0) || (sigchld_fd == -1)) {
+            break;
+        }
+
+        return_value = poll(&poll_fd, 1, (int)remaining);
+        if (return_value == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("error, poll");
+            break;
+        }
+
+        return_value = process_reap(list);
+        if (return_value > 0) {
+            quitting.num_running -= return_value;
+        }
+    }
+
+    return quit_finish(list);
+}
+
+int read_proc_file(int pid, const char *name, char *buffer, size_t size) {
+    // Description
+    // This function reads the file /proc/<pid>/<name> into buffer, which is
+    // size bytes long, and terminates it with a null character.
+    //
+    // Returns
+    // read_proc_file returns the number of bytes read or -1 in case of
+    // failure.
+
+    // variable declaration
+    char path[64];
+    int fd;
+    ssize_t num_read;
+
+    snprintf(path, sizeof(path), "/proc/%d/%s", pid, name);
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    num_read = read(fd, buffer, size - 1);
+    close(fd);
+    if (num_read == -1) {
+        return -1;
+    }
+
+    buffer[num_read] = '\0';
+
+    return (int)num_read;
+}
+
+const char *skip_fields(const char *str, int num_fields) {
+    // Description
+    // This function skips num_fields space separated fields of the string
+    // str.
+    //
+    // Returns
+    // skip_fields returns a pointer to the start of the next field, or to
+    // the terminating null character.
+
+    for (; num_fields > 0; num_fields--) {
+        while ((*str != ' ') && (*str != '\0')) {
+            str++;
+        }
+        while (*str == ' ') {
+            str++;
+        }
+    }
+
+    return str;
+}
+
+int usage_parse(const char *schedstat, const char *statm, usage_t *usage) {
+    // Description
+    // This function parses the contents of /proc/<pid>/schedstat and statm,
+    // storing the CPU time, the resident set size, and the number of context
+    // switches in usage. The first field of schedstat is the CPU time in
+    // nanoseconds and the third the number of timeslices run, which counts
+    // the context switches to the process. The second field of statm is
+    // the resident set size in pages.
+    //
+    // Returns
+    // usage_parse returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    static long page_kibibytes;
+    char *end;
+
+    if (page_kibibytes == 0) {
+        page_kibibytes = sysconf(_SC_PAGESIZE) / 1024;
+    }
+
+    usage->cpu_time = strtol(schedstat, &end, 10);
+    if (end == schedstat) {
+        return -1;
+    }
+    usage->context_switches = strtol(skip_fields(schedstat, 2), NULL, 10);
+    usage->rss = strtol(skip_fields(statm, 1), NULL, 10) * page_kibibytes;
+
+    return 0;
+}
+
+int usage_sample(process_t *process, long now) {
+    // Description
+    // This function samples the resource usage of the running process process
+    // from /proc at the time now, opening and reading the files directly.
+    // The CPU usage is computed over the time since the previous sample, or
+    // since the spawn of the process started, before which it used no CPU
+    // time. It is used when the sampler has no sample of the process yet.
+    //
+    // Returns
+    // usage_sample returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    char schedstat[MAX_PROC_FILE_LENGTH];
+    char statm[MAX_PROC_FILE_LENGTH];
+    usage_t usage;
+    long previous_time;
+    int return_value;  // integer placeholder for error checking
+
+    if ((read_proc_file(process->pid, "schedstat", schedstat,
+            sizeof(schedstat)) == -1) ||
+            (read_proc_file(process->pid, "statm", statm,
+            sizeof(statm)) == -1)) {
+        return -1;
+    }
+
+    return_value = usage_parse(schedstat, statm, &usage);
+    if (return_value == -1) {
+        return -1;
+    }
+
+    previous_time = process->usage.sample_time;
+    if (previous_time == 0) {
+        previous_time = process->usage.start_time;
+    }
+    if (now > previous_time) {
+        process->usage.cpu_percent = 100.0 *
+                (usage.cpu_time - process->usage.cpu_time) /
+                (now - previous_time);
+    }
+    process->usage.cpu_time = usage.cpu_time;
+    process->usage.rss = usage.rss;
+    process->usage.context_switches = usage.context_switches;
+    process->usage.sample_time = now;
+
+    return 0;
+}
+
+int sampler_start() {
+    // Description
+    // This function allocates the slots of the sampler and starts its thread.
+    // The sampler keeps two files open per process, within half of the limit
+    // of open files, the other half being left to the rest of scee. The
+    // processes beyond it are sampled directly by top. The limit isn't
+    // raised, as the children would inherit it.
+    //
+    // Returns
+    // sampler_start returns 0 on successful completion or -1 in case of
+    // failure, in which case top samples the processes directly.
+
+    // variable declaration
+    struct rlimit limit;
+    int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
+
+    sampler.max_open_files = 512;
+    return_value = getrlimit(RLIMIT_NOFILE, &limit);
+    if (return_value == 0) {
+        sampler.max_open_files = limit.rlim_cur / 2 < INT32_MAX ?
+                (int)(limit.rlim_cur / 2) : INT32_MAX;
+    }
+    sampler.num_open_files = 0;
+
+    sampler.slots = (sample_t *)calloc(MAX_SAMPLED_PROCESSES,
+            sizeof(sample_t));
+    sampler.free_slots = (int *)malloc(MAX_SAMPLED_PROCESSES * sizeof(int));
+    if ((sampler.slots == NULL) || (sampler.free_slots == NULL)) {
+        perror("error, malloc");
+        free(sampler.slots);
+        free(sampler.free_slots);
+        return -1;
+    }
+    for (i = 0; i < MAX_SAMPLED_PROCESSES; i++) {
+        sampler.slots[i].schedstat_fd = -1;
+        sampler.slots[i].statm_fd = -1;
+    }
+    atomic_store(&sampler.num_slots, 0);
+    sampler.num_free = 0;
+
+    return_value = pthread_create(&sampler.thread, NULL, sampler_run, NULL);
+    if (return_value != 0) {
+        printf("error, pthread_create: %s\n", strerror(return_value));
+        free(sampler.slots);
+        free(sampler.free_slots);
+        return -1;
+    }
+    pthread_detach(sampler.thread);
+
+    sampler.running = 1;
+
+    return 0;
+}
+
+void *sampler_run(void *argument) {
+    // Description
+    // This function is the body of the sampler thread. Every
+    // SAMPLE_INTERVAL_NANOSECONDS it rereads the /proc/<pid>/schedstat file,
+    // and every RSS_SAMPLE_TICKS samples the statm file, of every used slot
+    // with pread, keeping them open between samples, and publishes the parsed
+    // sample under the seqlock of the slot.
+    //
+    // Returns
+    // sampler_run doesn't return.
+
+    // variable declaration
+    sample_t *slot;
+    struct timespec tick;
+    char schedstat[MAX_PROC_FILE_LENGTH];
+    char statm[MAX_PROC_FILE_LENGTH];
+    char path[64];
+    usage_t usage;
+    ssize_t schedstat_length;
+    ssize_t statm_length;
+    long now;
+    long num_ticks;
+    int reread_statm;  // Boolean indicator that statm is reread this tick.
+    int num_slots;
+    unsigned int generation;
+    int pid;
+    int i;  // generic counter
+
+    (void)argument;
+
+    clock_gettime(CLOCK_MONOTONIC, &tick);
+    for (num_ticks = 0; ; num_ticks++) {
+        reread_statm = (num_ticks % RSS_SAMPLE_TICKS == 0);
+        num_slots = atomic_load_explicit(&sampler.num_slots,
+                memory_order_acquire);
+        now = monotonic_nanoseconds();
+
+        for (i = 0; i < num_slots; i++) {
+            slot = &sampler.slots[i];
+            generation = atomic_load_explicit(&slot->generation,
+                    memory_order_acquire);
+            pid = atomic_load_explicit(&slot->pid, memory_order_acquire);
+
+            // The slot was freed or reassigned, switch the open files.
+            statm_length = 0;
+            if ((pid != slot->open_pid) ||
+                    (generation != slot->open_generation)) {
+                if (slot->schedstat_fd != -1) {
+                    close(slot->schedstat_fd);
+                    close(slot->statm_fd);
+                    slot->schedstat_fd = -1;
+                    slot->statm_fd = -1;
+                    sampler.num_open_files -= 2;
+                }
+                slot->open_pid = 0;
+                if ((pid != 0) &&
+                        (sampler.num_open_files + 2 <=
+                        sampler.max_open_files)) {
+                    // Otherwise the files are opened once others are closed.
+                    slot->open_pid = pid;
+                    slot->open_generation = generation;
+                    snprintf(path, sizeof(path), "/proc/%d/schedstat", pid);
+                    slot->schedstat_fd = open(path, O_RDONLY | O_CLOEXEC);
+                    snprintf(path, sizeof(path), "/proc/%d/statm", pid);
+                    slot->statm_fd = open(path, O_RDONLY | O_CLOEXEC);
+                    if ((slot->schedstat_fd == -1) || (slot->statm_fd == -1)) {
+                        if (slot->schedstat_fd != -1) {
+                            close(slot->schedstat_fd);
+                        }
+                        if (slot->statm_fd != -1) {
+                            close(slot->statm_fd);
+                        }
+                        slot->schedstat_fd = -1;
+                        slot->statm_fd = -1;
+                    } else {
+                        sampler.num_open_files += 2;
+                    }
+                }
+            }
+
+            if ((pid == 0) || (slot->schedstat_fd == -1)) {
+                continue;
+            }
+
+            schedstat_length = pread(slot->schedstat_fd, schedstat,
+                    sizeof(schedstat) - 1, 0);
+            if (schedstat_length <= 0) {
+                continue;
+            }
+            schedstat[schedstat_length] = '\0';
+
+            // A new process always gets its resident set size sampled.
+            if (reread_statm || (slot->sampled_generation != generation)) {
+                statm_length = pread(slot->statm_fd, statm, sizeof(statm) - 1,
+                        0);
+                if (statm_length <= 0) {
+                    continue;
+                }
+                statm[statm_length] = '\0';
+            } else {
+                strcpy(statm, "0 0");
+            }
+            if (usage_parse(schedstat, statm, &usage) == -1) {
+                continue;
+            }
+            if (statm_length == 0) {
+                usage.rss = slot->rss;
+            }
+
+            // Publish the sample. Readers retry while the sequence is odd or
+            // has changed.
+            atomic_fetch_add_explicit(&slot->sequence, 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+            if ((slot->sampled_generation == generation) &&
+                    (now > slot->sample_time)) {
+                slot->cpu_percent = 100.0 * (usage.cpu_time - slot->cpu_time) /
+                        (now - slot->sample_time);
+            } else {
+                slot->cpu_percent = 0.0;
+            }
+            slot->sampled_generation = generation;
+            slot->sample_time = now;
+            slot->cpu_time = usage.cpu_time;
+            slot->rss = usage.rss;
+            slot->context_switches = usage.context_switches;
+            atomic_fetch_add_explicit(&slot->sequence, 1, memory_order_release);
+        }
+
+        // Sleep until the next tick.
+        tick.tv_nsec += SAMPLE_INTERVAL_NANOSECONDS % 1000000000L;
+        tick.tv_sec += SAMPLE_INTERVAL_NANOSECONDS / 1000000000L +
+                tick.tv_nsec / 1000000000L;
+        tick.tv_nsec %= 1000000000L;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tick, NULL) ==
+                EINTR);
+    }
+
+    return NULL;
+}
+
+void sampler_attach(process_t *process) {
+    // Description
+    // This function assigns a slot of the sampler to the process process.
+    // If the sampler isn't running or is full, the process isn't sampled
+    // in the background.
+    //
+    // Returns
+    // sampler_attach does not return any value.
+
+    // variable declaration
+    int slot;
+
+    process->sample_slot = -1;
+    if (!sampler.running) {
+        return;
+    }
+
+    if (sampler.num_free > 0) {
+        sampler.num_free--;
+        slot = sampler.free_slots[sampler.num_free];
+    } else {
+        slot = atomic_load_explicit(&sampler.num_slots, memory_order_relaxed);
+        if (slot == MAX_SAMPLED_PROCESSES) {
+            return;
+        }
+    }
+
+    // The PID is stored first, so that the thread sees it along with the new
+    // generation.
+    atomic_store_explicit(&sampler.slots[slot].pid, process->pid,
+            memory_order_relaxed);
+    atomic_fetch_add_explicit(&sampler.slots[slot].generation, 1,
+            memory_order_release);
+    if (slot == atomic_load_explicit(&sampler.num_slots,
+            memory_order_relaxed)) {
+        atomic_store_explicit(&sampler.num_slots, slot + 1,
+                memory_order_release);
+    }
+    process->sample_slot = slot;
+}
+
+void sampler_detach(process_t *process) {
+    // Description
+    // This function frees the slot of the sampler of the process process.
+    // The sampler thread closes its files on its next pass.
+    //
+    // Returns
+    // sampler_detach does not return any value.
+
+    if (process->sample_slot == -1) {
+        return;
+    }
+
+    atomic_store_explicit(&sampler.slots[process->sample_slot].pid, 0,
+            memory_order_release);
+    sampler.free_slots[sampler.num_free] = process->sample_slot;
+    sampler.num_free++;
+    process->sample_slot = -1;
+}
+
+int sampler_read(const process_t *process, usage_t *usage) {
+    // Description
+    // This function copies the latest sample of the process process published
+    // by the sampler thread into usage, without taking any lock.
+    //
+    // Returns
+    // sampler_read returns 0 on successful completion or -1 if there is no
+    // sample of the process yet.
+
+    // variable declaration
+    sample_t *slot;
+    unsigned int sequence;
+    unsigned int sampled_generation;
+
+    if (process->sample_slot == -1) {
+        return -1;
+    }
+    slot = &sampler.slots[process->sample_slot];
+
+    do {
+        sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        sampled_generation = slot->sampled_generation;
+        usage->sample_time = slot->sample_time;
+        usage->cpu_time = slot->cpu_time;
+        usage->rss = slot->rss;
+        usage->context_switches = slot->context_switches;
+        usage->cpu_percent = slot->cpu_percent;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) ||
+            (sequence != atomic_load_explicit(&slot->sequence,
+            memory_order_relaxed)));
+
+    if (sampled_generation != atomic_load_explicit(&slot->generation,
+            memory_order_relaxed)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int capture_start() {
+    // Description
+    // This function creates the epoll instance of the capturer and starts its
+    // thread.
+    //
+    // Returns
+    // capture_start returns 0 on successful completion or -1 in case of
+    // failure, in which case exec --capture is refused.
+
+    // variable declaration
+    int return_value;  // integer placeholder for error checking
+
+    capturer.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (capturer.epoll_fd == -1) {
+        perror("error, epoll_create1");
+        return -1;
+    }
+    pthread_mutex_init(&capturer.lock, NULL);
+    capturer.captures = NULL;
+    capturer.num_captures = 0;
+
+    return_value = pipe2(capturer.scratch_pipe, O_CLOEXEC | O_NONBLOCK);
+    if (return_value == -1) {
+        perror("error, pipe2");
+        close(capturer.epoll_fd);
+        return -1;
+    }
+    fcntl(capturer.scratch_pipe[1], F_SETPIPE_SZ, LOG_PIPE_SIZE);
+
+    return_value = pthread_create(&capturer.thread, NULL, capture_run, NULL);
+    if (return_value != 0) {
+        printf("error, pthread_create: %s\n", strerror(return_value));
+        close(capturer.epoll_fd);
+        close(capturer.scratch_pipe[0]);
+        close(capturer.scratch_pipe[1]);
+        return -1;
+    }
+    pthread_detach(capturer.thread);
+
+    capturer.running = 1;
+
+    return 0;
+}
+
+void *capture_run(void *argument) {
+    // Description
+    // This function is the body of the capture thread. It waits on the output
+    // pipes of all the captured processes with epoll and appends what they
+    // write to their ring buffers, or moves it to their log files with
+    // capture_log. Only one read is done per ready pipe and wakeup, so that
+    // a chatty process can't starve the others. A pipe is closed once
+    // the process and its descendants have closed its write end.
+    //
+    // The events carry the pipe descriptor rather than the ring buffer, which
+    // is looked up under the lock, so that a buffer freed by capture_detach
+    // in the meantime is never used.
+    //
+    // Returns
+    // capture_run does not return.
+
+    // variable declaration
+    struct epoll_event events[MAX_CAPTURE_EVENTS];
+    char data[CAPTURE_BUFFER_SIZE];
+    capture_t *capture;
+    ssize_t num_read;
+    int num_events;
+    int fd;
+    int i;  // generic counter
+
+    (void)argument;
+
+    for (;;) {
+        num_events = epoll_wait(capturer.epoll_fd, events, MAX_CAPTURE_EVENTS,
+                -1);
+        if (num_events == -1) {
+            continue;
+        }
+
+        for (i = 0; i < num_events; i++) {
+            fd = events[i].data.fd;
+
+            pthread_mutex_lock(&capturer.lock);
+            capture = (fd < capturer.num_captures) ?
+                    capturer.captures[fd] : NULL;
+            if (capture == NULL) {
+                pthread_mutex_unlock(&capturer.lock);
+                continue;
+            }
+
+            if (capture->log_fd != -1) {
+                num_read = capture_log(capture, data, sizeof(data));
+            } else {
+                num_read = read(fd, data, sizeof(data));
+                if ((num_read > 0) && capture->capturing) {
+                    capture_append(capture, data, (size_t)num_read);
+                }
+            }
+            if ((num_read == 0) ||
+                    ((num_read == -1) &&
+                    (errno != EAGAIN) && (errno != EINTR))) {
+                epoll_ctl(capturer.epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+                close(fd);
+                capturer.captures[fd] = NULL;
+                capture->fd = -1;
+            }
+            pthread_mutex_unlock(&capturer.lock);
+        }
+    }
+
+    return NULL;
+}
+
+int capture_attach(process_t *process, int fd, int capturing,
+        const char *log_path) {
+    // Description
+    // This function registers the read end fd of the output pipe of
+    // the process process with the capturer, which takes ownership of it.
+    // If capturing is set, a ring buffer is allocated for the output. If
+    // log_path isn't NULL, the output is appended to the file log_path.
+    // fd is closed in case of failure.
+    //
+    // Returns
+    // capture_attach returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    capture_t *capture;
+    capture_t **captures;
+    struct epoll_event event;
+    size_t size;
+    int num_captures;
+    int return_value;  // integer placeholder for error checking
+
+    size = sizeof(capture_t) + (capturing ? CAPTURE_BUFFER_SIZE : 0);
+    capture = (capture_t *)malloc(size);
+    if (capture == NULL) {
+        perror("error, malloc");
+        close(fd);
+        return -1;
+    }
+    capture->num_written = 0;
+    capture->fd = fd;
+    capture->capturing = capturing;
+    capture->log_fd = -1;
+    capture->log_path = NULL;
+    capture->log_size = 0;
+    atomic_init(&capture->num_logged, 0);
+    capture->rate_bytes = 0;
+    capture->rate_time = monotonic_nanoseconds();
+    capture->log_rate = 0.0;
+
+    if (log_path != NULL) {
+        capture->log_path = strdup(log_path);
+        if (capture->log_path == NULL) {
+            perror("error, strdup");
+            close(fd);
+            free(capture);
+            return -1;
+        }
+        capture->log_fd = log_open(log_path, &capture->log_size);
+        if (capture->log_fd == -1) {
+            printf("error, log_open\n");
+            close(fd);
+            free(capture->log_path);
+            free(capture);
+            return -1;
+        }
+
+        // A larger pipe lets a single splice move more output.
+        fcntl(fd, F_SETPIPE_SZ, LOG_PIPE_SIZE);
+    }
+
+    // The capture thread must never block on a pipe.
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    pthread_mutex_lock(&capturer.lock);
+
+    // Grow the table of ring buffers to fit fd.
+    if (fd >= capturer.num_captures) {
+        num_captures = capturer.num_captures > 0 ? capturer.num_captures : 64;
+        while (fd >= num_captures) {
+            num_captures *= 2;
+        }
+        captures = (capture_t **)realloc(capturer.captures,
+                (size_t)num_captures * sizeof(*captures));
+        if (captures == NULL) {
+            perror("error, realloc");
+            pthread_mutex_unlock(&capturer.lock);
+            capture->fd = -1;
+            close(fd);
+            process->capture = capture;
+            capture_bytes += size;
+            capture_detach(process);
+            return -1;
+        }
+        memset(&captures[capturer.num_captures], 0,
+                (size_t)(num_captures - capturer.num_captures) *
+                sizeof(*captures));
+        capturer.captures = captures;
+        capturer.num_captures = num_captures;
+    }
+    capturer.captures[fd] = capture;
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return_value = epoll_ctl(capturer.epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    if (return_value == -1) {
+        perror("error, epoll_ctl");
+        capturer.captures[fd] = NULL;
+        pthread_mutex_unlock(&capturer.lock);
+        capture->fd = -1;
+        close(fd);
+        process->capture = capture;
+        capture_bytes += size;
+        capture_detach(process);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&capturer.lock);
+
+    process->capture = capture;
+    capture_bytes += size;
+
+    return 0;
+}
+
+void capture_detach(process_t *process) {
+    // Description
+    // This function closes the output pipe and the log file of the process
+    // process, if they are open, and frees its ring buffer.
+    //
+    // Returns
+    // capture_detach does not return any value.
+
+    // variable declaration
+    capture_t *capture;
+
+    capture = process->capture;
+    if (capture == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&capturer.lock);
+    if (capture->fd != -1) {
+        epoll_ctl(capturer.epoll_fd, EPOLL_CTL_DEL, capture->fd, NULL);
+        close(capture->fd);
+        capturer.captures[capture->fd] = NULL;
+    }
+    pthread_mutex_unlock(&capturer.lock);
+
+    if (capture->log_fd != -1) {
+        close(capture->log_fd);
+    }
+    free(capture->log_path);
+    capture_bytes -= sizeof(capture_t) +
+            (capture->capturing ? CAPTURE_BUFFER_SIZE : 0);
+    free(capture);
+    process->capture = NULL;
+}
+
+void capture_append(capture_t *capture, const char *data, size_t length) {
+    // Description
+    // This function appends length bytes of data to the ring buffer capture,
+    // overwriting the oldest bytes once it is full.
+    //
+    // Returns
+    // capture_append does not return any value.
+
+    // variable declaration
+    size_t offset;
+    size_t chunk;
+
+    // Only the last CAPTURE_BUFFER_SIZE bytes would survive.
+    if (length > CAPTURE_BUFFER_SIZE) {
+        capture->num_written += length - CAPTURE_BUFFER_SIZE;
+        data += length - CAPTURE_BUFFER_SIZE;
+        length = CAPTURE_BUFFER_SIZE;
+    }
+
+    // Copy up to the end of the buffer, then wrap around.
+    offset = capture->num_written & (CAPTURE_BUFFER_SIZE - 1);
+    chunk = CAPTURE_BUFFER_SIZE - offset;
+    if (chunk > length) {
+        chunk = length;
+    }
+    memcpy(capture->data + offset, data, chunk);
+    memcpy(capture->data, data + chunk, length - chunk);
+
+    capture->num_written += length;
+}
+
+ssize_t capture_log(capture_t *capture, char *data, size_t size) {
+    // Description
+    // This function moves the output waiting in the pipe of capture to its
+    // log file with splice, without copying it through scee. If capture also
+    // has a ring buffer, the output is first duplicated with tee into
+    // the scratch pipe of the capturer, from which it is read, using data of
+    // size size, into the ring buffer. The log file is rotated once it grows
+    // beyond LOG_ROTATE_BYTES.
+    //
+    // Returns
+    // capture_log returns the number of bytes logged, 0 at the end of file,
+    // or -1 in case of failure, with errno set to EAGAIN if the pipe is
+    // empty.
+
+    // variable declaration
+    ssize_t length;  // The number of bytes to move.
+    ssize_t moved;  // The number of bytes moved.
+    ssize_t num_read;
+    int saved_errno;
+
+    if (capture->capturing) {
+        length = tee(capture->fd, capturer.scratch_pipe[1], LOG_PIPE_SIZE,
+                SPLICE_F_NONBLOCK);
+        if (length <= 0) {
+            return length;
+        }
+    } else {
+        length = LOG_PIPE_SIZE;
+    }
+
+    // When the output has been duplicated, exactly the duplicated bytes are
+    // moved, so that they aren't duplicated again.
+    moved = 0;
+    do {
+        num_read = splice(capture->fd, NULL, capture->log_fd, NULL,
+                (size_t)(length - moved), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (num_read > 0) {
+            moved += num_read;
+        }
+    } while (capture->capturing && (num_read > 0) && (moved < length));
+    saved_errno = errno;
+
+    if (capture->capturing) {
+        while ((num_read = read(capturer.scratch_pipe[0], data, size)) > 0) {
+            capture_append(capture, data, (size_t)num_read);
+        }
+    }
+
+    if (moved == 0) {
+        errno = saved_errno;
+        return capture->capturing ? -1 : num_read;
+    }
+
+    capture->log_size += moved;
+    atomic_fetch_add_explicit(&capture->num_logged, (unsigned long)moved,
+            memory_order_relaxed);
+    if (capture->log_size >= LOG_ROTATE_BYTES) {
+        log_rotate(capture);
+    }
+
+    return moved;
+}
+
+int log_open(const char *path, long *size) {
+    // Description
+    // This function opens the log file path for writing at its end, creating
+    // it if needed, and stores its current size in size. splice can't write
+    // to files opened with O_APPEND, so the offset is moved to the end
+    // instead.
+    //
+    // Returns
+    // log_open returns the file descriptor of the log file or -1 in case of
+    // failure.
+
+    // variable declaration
+    off_t offset;
+    int fd;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        perror("error, open");
+        return -1;
+    }
+
+    offset = lseek(fd, 0, SEEK_END);
+    if (offset == -1) {
+        perror("error, lseek");
+        close(fd);
+        return -1;
+    }
+    *size = (long)offset;
+
+    return fd;
+}
+
+int log_rotate(capture_t *capture) {
+    // Description
+    // This function rotates the log file of capture: <log>.1 to <log>.2 are
+    // renamed to <log>.2 to <log>.3, dropping the oldest one, <log> is
+    // renamed to <log>.1, and a new, empty <log> is opened.
+    //
+    // Returns
+    // log_rotate returns 0 on successful completion or -1 in case of failure,
+    // in which case the output keeps going to the current file until it grows
+    // by another LOG_ROTATE_BYTES.
+
+    // variable declaration
+    char old_path[MAX_PATH_LENGTH + 16];
+    char new_path[MAX_PATH_LENGTH + 16];
+    int fd;
+    int i;  // generic counter
+
+    for (i = LOG_ROTATIONS; i > 1; i--) {
+        snprintf(old_path, sizeof(old_path), "%s.%d", capture->log_path, i - 1);
+        snprintf(new_path, sizeof(new_path), "%s.%d", capture->log_path, i);
+        rename(old_path, new_path);
+    }
+    capture->log_size = 0;
+    if (rename(capture->log_path, old_path) == -1) {
+        return -1;
+    }
+
+    fd = open(capture->log_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+            0644);
+    if (fd == -1) {
+        // Keep writing to the renamed file.
+        return -1;
+    }
+
+    close(capture->log_fd);
+    capture->log_fd = fd;
+
+    return 0;
+}
+
+double log_rate(capture_t *capture, long now) {
+    // Description
+    // This function computes the rate at which the output of capture has been
+    // logged since the previous call, or since the process was spawned.
+    // Intervals shorter than a tenth of a second are too noisy, so
+    // the previous rate is kept for them.
+    //
+    // Returns
+    // log_rate returns the rate in bytes per second.
+
+    // variable declaration
+    unsigned long num_logged;
+    long elapsed;
+
+    elapsed = now - capture->rate_time;
+    if (elapsed >= 100000000L) {
+        num_logged = atomic_load_explicit(&capture->num_logged,
+                memory_order_relaxed);
+        capture->log_rate = (double)(num_logged - capture->rate_bytes) *
+                1000000000.0 / (double)elapsed;
+        capture->rate_bytes = num_logged;
+        capture->rate_time = now;
+    }
+
+    return capture->log_rate;
+}
+
+int capture_tail(const capture_t *capture, int num_lines, buffer_t *buffer) {
+    // Description
+    // This function appends to the buffer buffer the last num_lines lines
+    // kept in the ring buffer capture, terminated by a newline. The first
+    // line may be truncated if the ring buffer has wrapped around.
+    //
+    // Returns
+    // capture_tail returns the number of bytes appended or -1 in case of
+    // failure.
+
+    // variable declaration
+    unsigned long oldest;  // The position of the oldest byte kept.
+    unsigned long start;  // The position of the first byte to append.
+    unsigned long end;  // The position after the last byte to append.
+    size_t offset;
+    size_t length;
+    size_t chunk;
+    int return_value;  // integer placeholder for error checking
+
+    end = capture->num_written;
+    oldest = end > CAPTURE_BUFFER_SIZE ? end - CAPTURE_BUFFER_SIZE : 0;
+
+    // Walk back over num_lines newlines, not counting a final one.
+    start = end;
+    if ((start > oldest) &&
+            (capture->data[(start - 1) & (CAPTURE_BUFFER_SIZE - 1)] == '\n')) {
+        start--;
+    }
+    while ((start > oldest) && (num_lines > 0)) {
+        if (capture->data[(start - 1) & (CAPTURE_BUFFER_SIZE - 1)] == '\n') {
+            num_lines--;
+            if (num_lines == 0) {
+                break;
+            }
+        }
+        start--;
+    }
+
+    length = end - start;
+    if (length == 0) {
+        return 0;
+    }
+
+    return_value = buffer_reserve(buffer, length + 1);
+    if (return_value == -1) {
+        return -1;
+    }
+
+    offset = start & (CAPTURE_BUFFER_SIZE - 1);
+    chunk = CAPTURE_BUFFER_SIZE - offset;
+    if (chunk > length) {
+        chunk = length;
+    }
+    memcpy(buffer->data + buffer->length, capture->data + offset, chunk);
+    memcpy(buffer->data + buffer->length + chunk, capture->data,
+            length - chunk);
+    buffer->length += length;
+
+    if (buffer->data[buffer->length - 1] != '\n') {
+        buffer->data[buffer->length] = '\n';
+        buffer->length++;
+        length++;
+    }
+
+    return (int)length;
+}
+
+int process_tail(process_t *processes, char *arguments[]) {
+    // Description
+    // This function prints the last lines of output of the process with PID
+    // equal to the first element of arguments, provided it was spawned with
+    // exec --capture. The second element of arguments, if present, is
+    // the number of lines, TAIL_DEFAULT_LINES by default.
+    //
+    // Returns
+    // process_tail returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    buffer_t buffer = { NULL, 0, 0 };
+    process_t *result;
+    int num_lines;
+    int pid;
+    int return_value;  // integer placeholder for error checking
+
+    // process_tail requires a valid PID.
+    if (arguments[0] == NULL) {
+        printf("error, " ANSI_BOLD "tail" ANSI_RESET " requires a valid PID\n");
+        return 0;
+    }
+    pid = atoi(arguments[0]);
+
+    num_lines = TAIL_DEFAULT_LINES;
+    if (arguments[1] != NULL) {
+        num_lines = atoi(arguments[1]);
+        if (num_lines <= 0) {
+            printf("error, the number of lines of " ANSI_BOLD "tail" ANSI_RESET
+                    " must be positive\n");
+            return 0;
+        }
+    }
+
+    return_value = list_search(processes, &result, pid);
+    if (return_value == -1) {
+        printf("error, list_search\n");
+        return -1;
+    } else if (return_value == 0) {
+        printf("no process with PID %d\n", pid);
+        return 0;
+    } else if ((result->capture == NULL) || !result->capture->capturing) {
+        printf("the output of the process with PID %d is not captured\n", pid);
+        return 0;
+    }
+
+    // Copy the lines under the lock, and write them once it is released.
+    pthread_mutex_lock(&capturer.lock);
+    return_value = capture_tail(result->capture, num_lines, &buffer);
+    pthread_mutex_unlock(&capturer.lock);
+    if (return_value == -1) {
+        printf("error, capture_tail\n");
+        free(buffer.data);
+        return -1;
+    }
+
+    return_value = buffer_write(&buffer, STDOUT_FILENO);
+    free(buffer.data);
+
+    return return_value;
+}
+
+int process_stats(process_t *processes, char *arguments[]) {
+    // Description
+    // This function prints the number of times each command and system call
+    // has been executed, and the 50th and 99th percentiles and the maximum of
+    // its latency. If the first element of arguments is "--reset",
+    // the histograms are cleared afterwards.
+    //
+    // Returns
+    // process_stats returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    static buffer_t buffer;  // reused, so it rarely has to grow
+    const histogram_t *histogram;
+    int i;  // generic counter
+
+    (void)processes;
+
+    buffer_printf(&buffer, "\n%-12s  %10s  %12s  %12s  %12s\n", "operation",
+            "count", "p50 (us)", "p99 (us)", "max (us)");
+    for (i = 0; i < NUM_OPERATIONS; i++) {
+        histogram = &histograms[i];
+        if (histogram->count == 0) {
+            continue;
+        }
+        buffer_printf(&buffer, "%-12s  %10ld  %12.1f  %12.1f  %12.1f\n",
+                operation_names[i], histogram->count,
+                histogram_percentile(histogram, 50.0) / 1000.0,
+                histogram_percentile(histogram, 99.0) / 1000.0,
+                histogram->max / 1000.0);
+    }
+
+    if ((arguments[0] != NULL) && !strcmp(arguments[0], "--reset")) {
+        memset(histograms, 0, sizeof(histograms));
+    }
+
+    return buffer_write(&buffer, STDOUT_FILENO);
+}
+
+int sched_add(process_t *process) {
+    // Description
+    // This function adds the process process to the scheduler, which must be
+    // locked. It starts with the least virtual time of the last quantum, so
+    // that it neither starves the others nor waits for them to catch up.
+    //
+    // Returns
+    // sched_add returns 0 on successful completion or -1 in case of failure.
+
+    // variable declaration
+    sched_entry_t *entries;
+    sched_entry_t **order;
+    sched_entry_t *entry;
+    int capacity;
+
+    if (scheduler.num_entries == scheduler.capacity) {
+        capacity = scheduler.capacity ? 2 * scheduler.capacity : 64;
+        entries = (sched_entry_t *)realloc(scheduler.entries,
+                capacity * sizeof(sched_entry_t));
+        if (entries == NULL) {
+            perror("error, realloc");
+            return -1;
+        }
+        scheduler.entries = entries;
+        order = (sched_entry_t **)realloc(scheduler.order,
+                capacity * sizeof(sched_entry_t *));
+        if (order == NULL) {
+            perror("error, realloc");
+            return -1;
+        }
+        scheduler.order = order;
+        scheduler.capacity = capacity;
+    }
+
+    // The process keeps running until the next quantum.
+    entry = &scheduler.entries[scheduler.num_entries];
+    entry->pid = process->pid;
+    entry->weight = 1;
+    entry->active = 1;
+    entry->virtual_time = scheduler.min_virtual_time;
+    entry->run_time = 0;
+    entry->num_slices = 0;
+    entry->node = process;
+    process->sched_slot = scheduler.num_entries;
+    scheduler.num_entries++;
+
+    return 0;
+}
+
+void sched_attach(process_t *process) {
+    // Description
+    // This function lets the scheduler time-slice the process process, if
+    // the scheduler is enabled and the process is running and not throttled.
+    //
+    // Returns
+    // sched_attach does not return any value.
+
+    if (!scheduler.enabled || (process->sched_slot != -1) ||
+            process->stopped || process->exited || (process->cpu_limit > 0)) {
+        return;
+    }
+
+    pthread_mutex_lock(&scheduler.lock);
+    sched_add(process);
+    pthread_mutex_unlock(&scheduler.lock);
+}
+
+void sched_detach(process_t *process, int resume) {
+    // Description
+    // This function removes the process process from the scheduler. If resume
+    // is true and the scheduler has stopped the process, it is resumed.
+    //
+    // Returns
+    // sched_detach does not return any value.
+
+    // variable declaration
+    sched_entry_t *entry;
+    int slot;
+
+    slot = process->sched_slot;
+    if (slot == -1) {
+        return;
+    }
+
+    pthread_mutex_lock(&scheduler.lock);
+    entry = &scheduler.entries[slot];
+    if (resume && !entry->active) {
+        kill(entry->pid, SIGCONT);
+    }
+
+    // Move the last entry into the freed one.
+    scheduler.num_entries--;
+    if (slot != scheduler.num_entries) {
+        *entry = scheduler.entries[scheduler.num_entries];
+        entry->node->sched_slot = slot;
+    }
+    pthread_mutex_unlock(&scheduler.lock);
+
+    process->sched_slot = -1;
+}
+
+int sched_enable(process_t *processes, int max_running, long quantum) {
+    // Description
+    // This function lets at most max_running of the running processes of
+    // the list processes run at a time, switching them every quantum
+    // nanoseconds. The scheduler thread is started on first use, and
+    // the first quantum starts right away.
+    //
+    // Returns
+    // sched_enable returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    struct itimerspec timer;
+    process_t *node;
+    int return_value;  // integer placeholder for error checking
+
+    if (!scheduler.started) {
+        scheduler.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (scheduler.timer_fd == -1) {
+            perror("error, timerfd_create");
+            return -1;
+        }
+        return_value = pthread_create(&scheduler.thread, NULL, sched_run,
+                NULL);
+        if (return_value != 0) {
+            printf("error, pthread_create: %s\n", strerror(return_value));
+            close(scheduler.timer_fd);
+            scheduler.timer_fd = -1;
+            return -1;
+        }
+        pthread_detach(scheduler.thread);
+        scheduler.started = 1;
+    }
+
+    pthread_mutex_lock(&scheduler.lock);
+    if (!scheduler.enabled) {
+        scheduler.enabled = 1;
+        scheduler.min_virtual_time = 0;
+        scheduler.enabled_time = monotonic_nanoseconds();
+        scheduler.last_tick = scheduler.enabled_time;
+        scheduler.num_ticks = 0;
+        scheduler.num_signals = 0;
+        scheduler.overhead = 0;
+        memset(&scheduler.tick_histogram, 0, sizeof(histogram_t));
+        for (node = processes->next; node != processes; node = node->next) {
+            if (node->stopped || node->exited || (node->cpu_limit > 0)) {
+                continue;
+            }
+            if (sched_add(node) == -1) {
+                break;
+            }
+        }
+    }
+    scheduler.max_running = max_running;
+    scheduler.quantum = quantum;
+    pthread_mutex_unlock(&scheduler.lock);
+
+    // A zero it_value would disarm the timer.
+    timer.it_value.tv_sec = 0;
+    timer.it_value.tv_nsec = 1;
+    timer.it_interval.tv_sec = quantum / 1000000000L;
+    timer.it_interval.tv_nsec = quantum % 1000000000L;
+    return_value = timerfd_settime(scheduler.timer_fd, 0, &timer, NULL);
+    if (return_value == -1) {
+        perror("error, timerfd_settime");
+        sched_disable();
+        return -1;
+    }
+
+    return 0;
+}
+
+void sched_disable() {
+    // Description
+    // This function stops the scheduler and resumes the processes it has
+    // stopped.
+    //
+    // Returns
+    // sched_disable does not return any value.
+
+    // variable declaration
+    struct itimerspec timer;
+    int i;  // generic counter
+
+    if (!scheduler.enabled) {
+        return;
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    timerfd_settime(scheduler.timer_fd, 0, &timer, NULL);
+
+    pthread_mutex_lock(&scheduler.lock);
+    for (i = 0; i < scheduler.num_entries; i++) {
+        if (!scheduler.entries[i].active) {
+            kill(scheduler.entries[i].pid, SIGCONT);
+        }
+        scheduler.entries[i].node->sched_slot = -1;
+    }
+    scheduler.num_entries = 0;
+    scheduler.enabled = 0;
+    pthread_mutex_unlock(&scheduler.lock);
+}
+
+int compare_virtual_times(const void *a, const void *b) {
+    // Description
+    // This function compares two pointers to entries of the scheduler by
+    // their virtual time, then by their PID, for qsort.
+    //
+    // Returns
+    // compare_virtual_times returns a negative, zero, or positive integer if
+    // the first entry is to run before, together with, or after the second.
+
+    // variable declaration
+    const sched_entry_t *first = *(sched_entry_t * const *)a;
+    const sched_entry_t *second = *(sched_entry_t * const *)b;
+
+    if (first->virtual_time != second->virtual_time) {
+        return (first->virtual_time < second->virtual_time) ? -1 : 1;
+    }
+
+    return (first->pid > second->pid) - (first->pid < second->pid);
+}
+
+void sched_tick() {
+    // Description
+    // This function ends a quantum of the scheduler, which must be locked.
+    // The time since the last quantum is charged to the processes let run,
+    // then the max_running processes with the least virtual time are let run
+    // and the others are stopped. The stops are sent first, so that no more
+    // than max_running processes ever run at once.
+    //
+    // Returns
+    // sched_tick does not return any value.
+
+    // variable declaration
+    sched_entry_t *entry;
+    long start;
+    long elapsed;
+    int i;  // generic counter
+
+    start = monotonic_nanoseconds();
+    elapsed = start - scheduler.last_tick;
+    scheduler.last_tick = start;
+
+    for (i = 0; i < scheduler.num_entries; i++) {
+        entry = &scheduler.entries[i];
+        if (entry->active) {
+            entry->run_time += elapsed;
+            entry->virtual_time += elapsed / entry->weight;
+        }
+        scheduler.order[i] = entry;
+    }
+    qsort(scheduler.order, scheduler.num_entries, sizeof(sched_entry_t *),
+            compare_virtual_times);
+    if (scheduler.num_entries > 0) {
+        scheduler.min_virtual_time = scheduler.order[0]->virtual_time;
+    }
+
+    for (i = scheduler.max_running; i < scheduler.num_entries; i++) {
+        entry = scheduler.order[i];
+        if (entry->active) {
+            kill(entry->pid, SIGSTOP);
+            entry->active = 0;
+            scheduler.num_signals++;
+        }
+    }
+    for (i = 0; (i < scheduler.max_running) && (i < scheduler.num_entries);
+            i++) {
+        entry = scheduler.order[i];
+        if (!entry->active) {
+            kill(entry->pid, SIGCONT);
+            entry->active = 1;
+            scheduler.num_signals++;
+        }
+        entry->num_slices++;
+    }
+
+    elapsed = monotonic_nanoseconds() - start;
+    histogram_record(&scheduler.tick_histogram, elapsed);
+    scheduler.overhead += elapsed;
+    scheduler.num_ticks++;
+}
+
+void *sched_run(void *argument) {
+    // Description
+    // This function is the body of the scheduler thread. It ends a quantum
+    // every time the timer of the scheduler expires.
+    //
+    // Returns
+    // sched_run does not return.
+
+    // variable declaration
+    uint64_t num_expirations;
+    ssize_t length;
+
+    (void)argument;
+
+    while (1) {
+        length = read(scheduler.timer_fd, &num_expirations,
+                sizeof(num_expirations));
+        if (length != sizeof(num_expirations)) {
+            continue;
+        }
+
+        pthread_mutex_lock(&scheduler.lock);
+        if (scheduler.enabled) {
+            sched_tick();
+        }
+        pthread_mutex_unlock(&scheduler.lock);
+    }
+
+    return NULL;
+}
+
+int sched_report(buffer_t *buffer) {
+    // Description
+    // This function appends to buffer the state of the scheduler, the time
+    // it spends switching processes, and how fairly it shares the CPU time:
+    // Jain's index of the run time per weight of the processes, which is 1
+    // when they all get exactly their share. Each process is then listed
+    // with its weight, its run time, and its share of the total run time
+    // against the share its weight entitles it to.
+    //
+    // Returns
+    // sched_report returns 0 on successful completion.
+
+    // variable declaration
+    const sched_entry_t *entry;
+    double total_run_time;
+    double total_weight;
+    double sum;  // the sum of the run times per weight
+    double sum_squares;  // the sum of their squares
+    double normalized;
+    long lifetime;
+    int num_running;
+    int i;  // generic counter
+
+    if (!scheduler.enabled) {
+        buffer_printf(buffer, "scheduler off\n");
+        return 0;
+    }
+
+    total_run_time = 0.0;
+    total_weight = 0.0;
+    sum = 0.0;
+    sum_squares = 0.0;
+    num_running = 0;
+    for (i = 0; i < scheduler.num_entries; i++) {
+        entry = &scheduler.entries[i];
+        total_run_time += entry->run_time;
+        total_weight += entry->weight;
+        normalized = (double)entry->run_time / entry->weight;
+        sum += normalized;
+        sum_squares += normalized * normalized;
+        num_running += entry->active;
+    }
+    lifetime = monotonic_nanoseconds() - scheduler.enabled_time;
+
+    buffer_printf(buffer, "\nscheduler on, %d of %d processes running, "
+            "quantum %.1f ms\n", num_running, scheduler.num_entries,
+            scheduler.quantum / 1e6);
+    buffer_printf(buffer, "%ld quanta, %ld signals, switch p50 %.1f us, "
+            "p99 %.1f us, max %.1f us, overhead %.4f%%\n", scheduler.num_ticks,
+            scheduler.num_signals,
+            histogram_percentile(&scheduler.tick_histogram, 50.0) / 1000.0,
+            histogram_percentile(&scheduler.tick_histogram, 99.0) / 1000.0,
+            scheduler.tick_histogram.max / 1000.0,
+            lifetime > 0 ? 100.0 * scheduler.overhead / lifetime : 0.0);
+    buffer_printf(buffer, "fairness (Jain's index of run time per weight) "
+            "%.4f\n", sum_squares > 0.0 ?
+            sum * sum / (scheduler.num_entries * sum_squares) : 1.0);
+
+    buffer_printf(buffer, "\n%-8s  %6s  %-8s  %8s  %12s  %8s  %8s\n", "PID",
+            "weight", "state", "slices", "run time (s)", "share", "expected");
+    for (i = 0; i < scheduler.num_entries; i++) {
+        entry = &scheduler.entries[i];
+        buffer_printf(buffer, "%-8d  %6d  %-8s  %8ld  %12.3f  %7.1f%%  "
+                "%7.1f%%\n", entry->pid, entry->weight,
+                entry->active ? "running" : "paused", entry->num_slices,
+                entry->run_time / 1e9, total_run_time > 0.0 ?
+                100.0 * entry->run_time / total_run_time : 0.0,
+                100.0 * entry->weight / total_weight);
+    }
+
+    return 0;
+}
+
+int process_sched(process_t *processes, char *arguments[]) {
+    // Description
+    // This function controls the scheduler. "on K [QUANTUM_MS]" lets at most
+    // K processes run at a time, "off" lets them all run, "weight PID W"
+    // gives the process PID W times the CPU time of a process of weight 1,
+    // and no arguments print the state of the scheduler.
+    //
+    // Returns
+    // process_sched returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    static buffer_t buffer;  // reused, so it rarely has to grow
+    process_t *node;
+    long quantum;
+    int max_running;
+    int weight;
+    int return_value;  // integer placeholder for error checking
+
+    if (arguments[0] == NULL) {
+        pthread_mutex_lock(&scheduler.lock);
+        sched_report(&buffer);
+        pthread_mutex_unlock(&scheduler.lock);
+        return buffer_write(&buffer, STDOUT_FILENO);
+    }
+
+    if (!strcmp(arguments[0], "on")) {
+        if (arguments[1] == NULL) {
+            printf("error, sched on needs the number of running processes\n");
+            return -1;
+        }
+        max_running = atoi(arguments[1]);
+        quantum = (arguments[2] != NULL) ? atol(arguments[2]) :
+                SCHED_DEFAULT_QUANTUM_MILLISECONDS;
+        if ((max_running < 1) || (quantum < 1)) {
+            printf("error, the number of running processes and the quantum "
+                    "must be positive\n");
+            return -1;
+        }
+        return sched_enable(processes, max_running, quantum * 1000000L);
+    }
+
+    if (!strcmp(arguments[0], "off")) {
+        sched_disable();
+        return 0;
+    }
+
+    if (!strcmp(arguments[0], "weight")) {
+        if ((arguments[1] == NULL) || (arguments[2] == NULL)) {
+            printf("error, sched weight needs a PID and a weight\n");
+            return -1;
+        }
+        weight = atoi(arguments[2]);
+        if ((weight < 1) || (weight > SCHED_MAX_WEIGHT)) {
+            printf("error, the weight must be between 1 and %d\n",
+                    SCHED_MAX_WEIGHT);
+            return -1;
+        }
+        return_value = list_search(processes, &node, atoi(arguments[1]));
+        if ((return_value != 1) || (node->sched_slot == -1)) {
+            printf("error, process %s isn't scheduled\n", arguments[1]);
+            return -1;
+        }
+        pthread_mutex_lock(&scheduler.lock);
+        scheduler.entries[node->sched_slot].weight = weight;
+        pthread_mutex_unlock(&scheduler.lock);
+        return 0;
+    }
+
+    printf("error, unknown sched argument %s\n", arguments[0]);
+
+    return -1;
+}
+
+long throttle_read(int schedstat_fd) {
+    // Description
+    // This function reads the CPU time of a process from its
+    // /proc/<pid>/schedstat file, open as schedstat_fd.
+    //
+    // Returns
+    // throttle_read returns the CPU time in nanoseconds or -1 in case of
+    // failure.
+
+    // variable declaration
+    char schedstat[128];
+    ssize_t length;
+
+    length = pread(schedstat_fd, schedstat, sizeof(schedstat) - 1, 0);
+    if (length <= 0) {
+        return -1;
+    }
+    schedstat[length] = '\0';
+
+    return strtol(schedstat, NULL, 10);
+}
+
+void throttle_attach(process_t *process) {
+    // Description
+    // This function lets the throttler cap the CPU usage of the process
+    // process, if it has a CPU limit and is running. The throttler thread is
+    // started on first use, and its timer runs only while there are processes
+    // to throttle.
+    //
+    // Returns
+    // throttle_attach does not return any value.
+
+    // variable declaration
+    char path[64];
+    struct itimerspec timer;
+    throttle_entry_t *entries;
+    throttle_entry_t *entry;
+    int schedstat_fd;
+    int capacity;
+    int return_value;  // integer placeholder for error checking
+
+    if ((process->cpu_limit == 0) || (process->throttle_slot != -1) ||
+            process->stopped || process->exited) {
+        return;
+    }
+
+    if (!throttler.started) {
+        throttler.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (throttler.timer_fd == -1) {
+            perror("error, timerfd_create");
+            return;
+        }
+        return_value = pthread_create(&throttler.thread, NULL, throttle_run,
+                NULL);
+        if (return_value != 0) {
+            printf("error, pthread_create: %s\n", strerror(return_value));
+            close(throttler.timer_fd);
+            throttler.timer_fd = -1;
+            return;
+        }
+        pthread_detach(throttler.thread);
+        throttler.started = 1;
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/schedstat", process->pid);
+    schedstat_fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (schedstat_fd == -1) {
+        perror("error, open");
+        return;
+    }
+
+    pthread_mutex_lock(&throttler.lock);
+    if (throttler.num_entries == throttler.capacity) {
+        capacity = throttler.capacity ? 2 * throttler.capacity : 64;
+        entries = (throttle_entry_t *)realloc(throttler.entries,
+                capacity * sizeof(throttle_entry_t));
+        if (entries == NULL) {
+            perror("error, realloc");
+            pthread_mutex_unlock(&throttler.lock);
+            close(schedstat_fd);
+            return;
+        }
+        throttler.entries = entries;
+        throttler.capacity = capacity;
+    }
+
+    entry = &throttler.entries[throttler.num_entries];
+    entry->pid = process->pid;
+    entry->cpu_limit = process->cpu_limit;
+    entry->active = 1;
+    entry->schedstat_fd = schedstat_fd;
+    entry->cpu_time = throttle_read(schedstat_fd);
+    entry->credit = 0;
+    entry->start_cpu_time = entry->cpu_time;
+    entry->start_time = monotonic_nanoseconds();
+    entry->num_stops = 0;
+    entry->node = process;
+    process->throttle_slot = throttler.num_entries;
+    throttler.num_entries++;
+
+    // Start ticking with the first process.
+    if (throttler.num_entries == 1) {
+        throttler.last_tick = monotonic_nanoseconds();
+        timer.it_value.tv_sec = 0;
+        timer.it_value.tv_nsec = THROTTLE_INTERVAL_NANOSECONDS;
+        timer.it_interval = timer.it_value;
+        timerfd_settime(throttler.timer_fd, 0, &timer, NULL);
+    }
+    pthread_mutex_unlock(&throttler.lock);
+}
+
+void throttle_detach(process_t *process, int resume) {
+    // Description
+    // This function removes the process process from the throttler, keeping
+    // its CPU limit. If resume is true and the throttler has stopped
+    // the process, it is resumed.
+    //
+    // Returns
+    // throttle_detach does not return any value.
+
+    // variable declaration
+    struct itimerspec timer;
+    throttle_entry_t *entry;
+    int slot;
+
+    slot = process->throttle_slot;
+    if (slot == -1) {
+        return;
+    }
+
+    pthread_mutex_lock(&throttler.lock);
+    entry = &throttler.entries[slot];
+    if (resume && !entry->active) {
+        kill(entry->pid, SIGCONT);
+    }
+    close(entry->schedstat_fd);
+
+    // Move the last entry into the freed one.
+    throttler.num_entries--;
+    if (slot != throttler.num_entries) {
+        *entry = throttler.entries[throttler.num_entries];
+        entry->node->throttle_slot = slot;
+    }
+
+    // Stop ticking with the last process.
+    if (throttler.num_entries == 0) {
+        memset(&timer, 0, sizeof(timer));
+        timerfd_settime(throttler.timer_fd, 0, &timer, NULL);
+    }
+    pthread_mutex_unlock(&throttler.lock);
+
+    process->throttle_slot = -1;
+}
+
+int throttle_set(process_t *process, int cpu_limit) {
+    // Description
+    // This function caps the CPU usage of the process process at cpu_limit
+    // percent of a CPU, or lifts its cap if cpu_limit is 0. A capped process
+    // is taken out of the scheduler, and put back once its cap is lifted.
+    //
+    // Returns
+    // throttle_set returns 0 on successful completion or -1 in case of
+    // failure.
+
+    throttle_detach(process, 1);
+    process->cpu_limit = cpu_limit;
+    if (cpu_limit == 0) {
+        sched_attach(process);
+        return 0;
+    }
+
+    sched_detach(process, 1);
+    throttle_attach(process);
+    if ((process->throttle_slot == -1) && !process->stopped &&
+            !process->exited) {
+        return -1;
+    }
+
+    return 0;
+}
+
+void throttle_clear() {
+    // Description
+    // This function removes all the processes from the throttler and resumes
+    // those it has stopped.
+    //
+    // Returns
+    // throttle_clear does not return any value.
+
+    // variable declaration
+    struct itimerspec timer;
+    throttle_entry_t *entry;
+    int i;  // generic counter
+
+    pthread_mutex_lock(&throttler.lock);
+    for (i = 0; i < throttler.num_entries; i++) {
+        entry = &throttler.entries[i];
+        if (!entry->active) {
+            kill(entry->pid, SIGCONT);
+        }
+        close(entry->schedstat_fd);
+        entry->node->throttle_slot = -1;
+    }
+    if (throttler.num_entries > 0) {
+        memset(&timer, 0, sizeof(timer));
+        timerfd_settime(throttler.timer_fd, 0, &timer, NULL);
+    }
+    throttler.num_entries = 0;
+    pthread_mutex_unlock(&throttler.lock);
+}
+
+void throttle_tick() {
+    // Description
+    // This function is a tick of the throttler, which must be locked. Every
+    // process is credited with its share of the time since the last tick and
+    // debited with the CPU time it used, then stopped if it has overspent or
+    // resumed if it has credit again. The credit is bounded by the share of
+    // THROTTLE_PERIOD_NANOSECONDS either way, so a process that has slept
+    // can't burst for long, and one that has overspent is not stopped for
+    // long.
+    //
+    // Returns
+    // throttle_tick does not return any value.
+
+    // variable declaration
+    throttle_entry_t *entry;
+    long start;
+    long elapsed;
+    long cpu_time;
+    long bound;
+    int i;  // generic counter
+
+    start = monotonic_nanoseconds();
+    elapsed = start - throttler.last_tick;
+    throttler.last_tick = start;
+
+    for (i = 0; i < throttler.num_entries; i++) {
+        entry = &throttler.entries[i];
+
+        // A paused process uses no CPU time, so it isn't read. What it used
+        // after being stopped is debited once it is read again.
+        if (entry->active) {
+            cpu_time = throttle_read(entry->schedstat_fd);
+            if (cpu_time == -1) {
+                // The process has exited and is about to be reaped.
+                continue;
+            }
+        } else {
+            cpu_time = entry->cpu_time;
+        }
+
+        bound = THROTTLE_PERIOD_NANOSECONDS * entry->cpu_limit / 100;
+        entry->credit += elapsed * entry->cpu_limit / 100 -
+                (cpu_time - entry->cpu_time);
+        entry->cpu_time = cpu_time;
+        if (entry->credit > bound) {
+            entry->credit = bound;
+        } else if (entry->credit < -bound) {
+            entry->credit = -bound;
+        }
+
+        if (entry->active && (entry->credit <= 0)) {
+            kill(entry->pid, SIGSTOP);
+            entry->active = 0;
+            entry->num_stops++;
+            throttler.num_signals++;
+        } else if (!entry->active && (entry->credit > 0)) {
+            kill(entry->pid, SIGCONT);
+            entry->active = 1;
+            throttler.num_signals++;
+        }
+    }
+
+    histogram_record(&throttler.tick_histogram,
+            monotonic_nanoseconds() - start);
+    throttler.num_ticks++;
+}
+
+void *throttle_run(void *argument) {
+    // Description
+    // This function is the body of the throttler thread. It runs a tick every
+    // time the timer of the throttler expires.
+    //
+    // Returns
+    // throttle_run does not return.
+
+    // variable declaration
+    uint64_t num_expirations;
+    ssize_t length;
+
+    (void)argument;
+
+    while (1) {
+        length = read(throttler.timer_fd, &num_expirations,
+                sizeof(num_expirations));
+        if (length != sizeof(num_expirations)) {
+            continue;
+        }
+
+        pthread_mutex_lock(&throttler.lock);
+        if (throttler.num_entries > 0) {
+            throttle_tick();
+        }
+        pthread_mutex_unlock(&throttler.lock);
+    }
+
+    return NULL;
+}
+
+int process_limit(process_t *processes, char *arguments[]) {
+    // Description
+    // This function caps the CPU usage of the process with PID equal to
+    // the first element of arguments at the percentage of a CPU given by
+    // the second one, optionally followed by %, "off" lifting the cap.
+    // Without arguments, the capped processes are printed with their limit
+    // and their average CPU usage since they were capped.
+    //
+    // Returns
+    // process_limit returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    static buffer_t buffer;  // reused, so it rarely has to grow
+    const throttle_entry_t *entry;
+    process_t *node;
+    char *end;
+    long now;
+    long cpu_limit;
+    int return_value;  // integer placeholder for error checking
+
+    if (arguments[0] == NULL) {
+        pthread_mutex_lock(&throttler.lock);
+        buffer_printf(&buffer, "\n%d processes throttled, %ld ticks, "
+                "%ld signals, tick p50 %.1f us, p99 %.1f us\n",
+                throttler.num_entries, throttler.num_ticks,
+                throttler.num_signals,
+                histogram_percentile(&throttler.tick_histogram, 50.0) / 1000.0,
+                histogram_percentile(&throttler.tick_histogram, 99.0) / 1000.0);
+        buffer_printf(&buffer, "\n%-8s  %8s  %8s  %-8s  %8s\n", "PID",
+                "limit", "usage", "state", "stops");
+        now = monotonic_nanoseconds();
+        for (node = processes->next; node != processes; node = node->next) {
+            if (node->cpu_limit == 0) {
+                continue;
+            }
+            if (node->throttle_slot == -1) {
+                buffer_printf(&buffer, "%-8d  %7d%%  %8s  %-8s  %8s\n",
+                        node->pid, node->cpu_limit, "-",
+                        node->exited ? "exited" : "stopped", "-");
+                continue;
+            }
+            entry = &throttler.entries[node->throttle_slot];
+            buffer_printf(&buffer, "%-8d  %7d%%  %7.1f%%  %-8s  %8ld\n",
+                    node->pid, node->cpu_limit, now > entry->start_time ?
+                    100.0 * (entry->cpu_time - entry->start_cpu_time) /
+                    (now - entry->start_time) : 0.0,
+                    entry->active ? "running" : "paused", entry->num_stops);
+        }
+        pthread_mutex_unlock(&throttler.lock);
+        return buffer_write(&buffer, STDOUT_FILENO);
+    }
+
+    if (arguments[1] == NULL) {
+        printf("error, " ANSI_BOLD "limit" ANSI_RESET
+                " requires a PID and a percentage\n");
+        return 0;
+    }
+    if (!strcmp(arguments[1], "off")) {
+        cpu_limit = 0;
+    } else {
+        cpu_limit = strtol(arguments[1], &end, 10);
+        if (*end == '%') {
+            end++;
+        }
+        if ((end == arguments[1]) || (*end != '\0') || (cpu_limit < 1) ||
+                (cpu_limit > MAX_CPU_LIMIT)) {
+            printf("error, the CPU limit must be between 1%% and %d%%, or "
+                    "off\n", MAX_CPU_LIMIT);
+            return 0;
+        }
+    }
+
+    return_value = list_search(processes, &node, atoi(arguments[0]));
     if (return_value == -1) {
-        perror("error, sigaction");
+        printf("error, list_search\n");
         return -1;
+    } else if (return_value == 0) {
+        printf("no process with PID %s\n", arguments[0]);
+    } else if (node->exited) {
+        printf("the process with PID %d has exited\n", node->pid);
+    } else {
+        return_value = throttle_set(node, (int)cpu_limit);
+        if (return_value == -1) {
+            printf("error, throttle_set\n");
+            return -1;
+        }
+        if (cpu_limit == 0) {
+            printf("the CPU usage of the process with PID %d is no longer "
+                    "limited\n", node->pid);
+        } else {
+            printf("the CPU usage of the process with PID %d is limited to "
+                    "%ld%%\n", node->pid, cpu_limit);
+        }
     }
 
     return 0;
 }
 
-int child_signal_handling() {
+int cpuset_parse(const char *string, cpu_set_t *set) {
     // Description
-    // This function contains the signal handling code of the child processes
-    // of the application. It unblocks the signals SIGTERM, SIGSTOP, SIGCONT,
-    // and SIGUSR1.
+    // This function parses the list of CPUs string, such as "0-3,8,10-11",
+    // into set.
     //
     // Returns
-    // child_signal_handling returns 0 on successful completion or
-    // -1 in case of failure.
+    // cpuset_parse returns 0 on successful completion or -1 if string isn't
+    // a valid list of CPUs.
+
+    // variable declaration
+    char *end;
+    long first;
+    long last;
+
+    CPU_ZERO(set);
+    do {
+        first = strtol(string, &end, 10);
+        if ((end == string) || (first < 0) || (first >= CPU_SETSIZE)) {
+            return -1;
+        }
+        last = first;
+        if (*end == '-') {
+            string = end + 1;
+            last = strtol(string, &end, 10);
+            if ((end == string) || (last < first) || (last >= CPU_SETSIZE)) {
+                return -1;
+            }
+        }
+        for (; first <= last; first++) {
+            CPU_SET(first, set);
+        }
+        string = end + 1;
+    } while (*end == ',');
+
+    if ((*end != '\0') && (*end != '\n')) {
+        return -1;
+    }
+
+    return CPU_COUNT(set) > 0 ? 0 : -1;
+}
+
+void cpuset_format(const cpu_set_t *set, char *string, size_t size) {
+    // Description
+    // This function stores in string, which is size bytes long, the CPUs of
+    // set as a list of ranges, such as "0-3,8". The list is truncated if it
+    // doesn't fit.
+    //
+    // Returns
+    // cpuset_format does not return any value.
+
+    // variable declaration
+    size_t length;
+    int first;
+    int last;
+
+    length = 0;
+    string[0] = '\0';
+    for (first = 0; first < CPU_SETSIZE; first++) {
+        if (!CPU_ISSET(first, set)) {
+            continue;
+        }
+        for (last = first; (last + 1 < CPU_SETSIZE) &&
+                CPU_ISSET(last + 1, set); last++);
+        length += snprintf(string + length, size - length,
+                (last > first) ? "%s%d-%d" : "%s%d", length ? "," : "",
+                first, last);
+        if (length >= size) {
+            return;
+        }
+        first = last;
+    }
+}
+
+void topology_load() {
+    // Description
+    // This function reads the CPUs scee may run on and the CPUs of every NUMA
+    // node into topology. Without NUMA information, all the CPUs are taken
+    // to belong to node 0.
+    //
+    // Returns
+    // topology_load does not return any value.
+
+    // variable declaration
+    char path[64];
+    char list[4096];
+    cpu_set_t nodes;
+    ssize_t length;
+    int fd;
+    int node;
+
+    topology.loaded = 1;
+    topology.num_nodes = 0;
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &topology.cpus) == -1) {
+        perror("error, sched_getaffinity");
+        CPU_ZERO(&topology.cpus);
+        CPU_SET(0, &topology.cpus);
+    }
+
+    // The node numbers are read as a list of CPUs, which has the same format.
+    fd = open("/sys/devices/system/node/online", O_RDONLY | O_CLOEXEC);
+    length = (fd != -1) ? read(fd, list, sizeof(list) - 1) : -1;
+    if (fd != -1) {
+        close(fd);
+    }
+    if (length > 0) {
+        list[length] = '\0';
+    }
+    if ((length > 0) && (cpuset_parse(list, &nodes) == 0)) {
+        for (node = 0; (node < CPU_SETSIZE) &&
+                (topology.num_nodes < MAX_NUMA_NODES); node++) {
+            if (!CPU_ISSET(node, &nodes)) {
+                continue;
+            }
+            snprintf(path, sizeof(path),
+                    "/sys/devices/system/node/node%d/cpulist", node);
+            fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd == -1) {
+                continue;
+            }
+            length = read(fd, list, sizeof(list) - 1);
+            close(fd);
+            if (length <= 0) {
+                continue;
+            }
+            list[length] = '\0';
+
+            // Memory-only nodes have no CPUs to place processes on.
+            if (cpuset_parse(list,
+                    &topology.node_cpus[topology.num_nodes]) == 0) {
+                topology.node_ids[topology.num_nodes] = node;
+                topology.num_nodes++;
+            }
+        }
+    }
+
+    if (topology.num_nodes == 0) {
+        topology.node_ids[0] = 0;
+        topology.node_cpus[0] = topology.cpus;
+        topology.num_nodes = 1;
+    }
+}
+
+int placement_choose(const exec_options_t *options, cpu_set_t *cpus,
+        unsigned long *nodemask, char *description) {
+    // Description
+    // This function chooses the CPUs of the next process spawned with
+    // the options options and stores them in cpus, the NUMA nodes they belong
+    // to in nodemask, and a description of at most MAX_PLACEMENT_LENGTH
+    // characters in description. The CPUs are those scee may run on, or
+    // those of options among them, narrowed down to a single CPU or node if
+    // the processes are spread. Successive calls take the next CPU or node,
+    // round-robin, also across exec commands.
+    //
+    // Returns
+    // placement_choose returns 0 on successful completion or -1 if there are
+    // no CPUs to place the process on.
+
+    // variable declaration
+    cpu_set_t allowed;
+    cpu_set_t candidates[MAX_NUMA_NODES];  // the allowed CPUs of every node
+    int candidate_nodes[MAX_NUMA_NODES];
+    int num_candidates;
+    int index;
+    int cpu;
+    int i;  // generic counter
+
+    if (!topology.loaded) {
+        topology_load();
+    }
+
+    // The CPUs scee may not run on aren't available to the processes either.
+    allowed = topology.cpus;
+    if (options->has_cpus) {
+        CPU_AND(&allowed, &allowed, &options->cpus);
+    }
+    if (CPU_COUNT(&allowed) == 0) {
+        return -1;
+    }
+
+    if (options->spread == SPREAD_CPU) {
+        // Take the next allowed CPU.
+        index = placement_next++ % CPU_COUNT(&allowed);
+        for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed) && (index-- == 0)) {
+                break;
+            }
+        }
+        CPU_ZERO(cpus);
+        CPU_SET(cpu, cpus);
+        snprintf(description, MAX_PLACEMENT_LENGTH + 1, "cpu %d", cpu);
+    } else if (options->spread == SPREAD_NODE) {
+        // Take the allowed CPUs of the next node that has some.
+        num_candidates = 0;
+        for (i = 0; i < topology.num_nodes; i++) {
+            CPU_AND(&candidates[num_candidates], &allowed,
+                    &topology.node_cpus[i]);
+            if (CPU_COUNT(&candidates[num_candidates]) > 0) {
+                candidate_nodes[num_candidates] = topology.node_ids[i];
+                num_candidates++;
+            }
+        }
+        if (num_candidates == 0) {
+            return -1;
+        }
+        index = placement_next++ % num_candidates;
+        *cpus = candidates[index];
+        snprintf(description, MAX_PLACEMENT_LENGTH + 1, "node %d",
+                candidate_nodes[index]);
+    } else {
+        *cpus = allowed;
+        strcpy(description, "cpus ");
+        cpuset_format(cpus, description + strlen("cpus "),
+                MAX_PLACEMENT_LENGTH + 1 - strlen("cpus "));
+    }
+
+    // The memory of the process comes from the nodes of its CPUs.
+    *nodemask = 0;
+    for (i = 0; i < topology.num_nodes; i++) {
+        CPU_AND(&allowed, cpus, &topology.node_cpus[i]);
+        if ((CPU_COUNT(&allowed) > 0) && (topology.node_ids[i] < 64)) {
+            *nodemask |= 1UL << topology.node_ids[i];
+        }
+    }
+    if (options->membind) {
+        strncat(description, ", membind",
+                MAX_PLACEMENT_LENGTH - strlen(description));
+    } else {
+        *nodemask = 0;
+    }
+
+    return 0;
+}
+
+int placement_apply(const cpu_set_t *cpus, unsigned long nodemask) {
+    // Description
+    // This function binds the calling thread to the CPUs cpus and, unless
+    // nodemask is 0, its memory allocations to the NUMA nodes of nodemask.
+    // Both are inherited by the processes the thread spawns. set_mempolicy
+    // is called directly, so that scee doesn't depend on libnuma.
+    //
+    // Returns
+    // placement_apply returns 0 on successful completion or -1 in case of
+    // failure.
 
     // variable declaration
-    sigset_t signals_set;
     int return_value;  // integer placeholder for error checking
 
-    return_value = sigemptyset(&signals_set);
+    return_value = sched_setaffinity(0, sizeof(cpu_set_t), cpus);
     if (return_value == -1) {
-        perror("error, sigemptyset");
+        perror("error, sched_setaffinity");
         return -1;
     }
 
-    return_value = sigaddset(&signals_set, SIGTERM);
-    if (return_value == -1) {
-        perror("error, sigaddset");
+    if (nodemask != 0) {
+        return_value = (int)syscall(SYS_set_mempolicy, MPOL_BIND, &nodemask,
+                8 * sizeof(nodemask) + 1);
+        if (return_value == -1) {
+            perror("error, set_mempolicy");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+void placement_restore() {
+    // Description
+    // This function undoes placement_apply on the calling thread, letting it
+    // run on the CPUs scee was started with and allocate memory anywhere.
+    //
+    // Returns
+    // placement_restore does not return any value.
+
+    sched_setaffinity(0, sizeof(cpu_set_t), &topology.cpus);
+    syscall(SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0);
+}
+
+int placement_current(int pid, int *cpu) {
+    // Description
+    // This function stores in cpu the CPU the process with PID pid last ran
+    // on, the 39th field of /proc/<pid>/stat. The fields are counted from
+    // the end of the name of the program, which may contain spaces.
+    //
+    // Returns
+    // placement_current returns the NUMA node of the CPU or -1 in case of
+    // failure.
+
+    // variable declaration
+    char stat[1024];
+    const char *fields;
+    int i;  // generic counter
+
+    if (read_proc_file(pid, "stat", stat, sizeof(stat)) == -1) {
         return -1;
     }
-    return_value = sigaddset(&signals_set, SIGSTOP);
-    if (return_value == -1) {
-        perror("error, sigaddset");
+    fields = strrchr(stat, ')');
+    if (fields == NULL) {
         return -1;
     }
-    return_value = sigaddset(&signals_set, SIGCONT);
-    if (return_value == -1) {
-        perror("error, sigaddset");
+    *cpu = atoi(skip_fields(fields + 2, 36));
+
+    if (!topology.loaded) {
+        topology_load();
+    }
+    for (i = 0; i < topology.num_nodes; i++) {
+        if ((*cpu < CPU_SETSIZE) && CPU_ISSET(*cpu, &topology.node_cpus[i])) {
+            return topology.node_ids[i];
+        }
+    }
+
+    return 0;
+}
+
+int parse_size(const char *string, long *size) {
+    // Description
+    // This function parses the size string, a number of bytes optionally
+    // followed by K, M, or G for KiB, MiB, or GiB, into size.
+    //
+    // Returns
+    // parse_size returns 0 on successful completion or -1 if string isn't
+    // a valid positive size.
+
+    // variable declaration
+    char *end;
+    long value;
+    int shift;
+
+    value = strtol(string, &end, 10);
+    if ((end == string) || (value <= 0)) {
         return -1;
     }
-    return_value = sigaddset(&signals_set, SIGUSR1);
-    if (return_value == -1) {
-        perror("error, sigaddset");
+
+    switch (*end) {
+    case '\0':
+        shift = 0;
+        break;
+    case 'K': case 'k':
+        shift = 10;
+        break;
+    case 'M': case 'm':
+        shift = 20;
+        break;
+    case 'G': case 'g':
+        shift = 30;
+        break;
+    default:
+        return -1;
+    }
+    if ((shift > 0) && (end[1] != '\0')) {
         return -1;
     }
+    if (value > (LONG_MAX >> shift)) {
+        return -1;
+    }
+    *size = value << shift;
 
-    return_value = sigprocmask(SIG_UNBLOCK, &signals_set, NULL);
-    if (return_value == -1) {
-        perror("error, sigprocmask");
+    return 0;
+}
+
+int limits_apply(int pid, const exec_options_t *options) {
+    // Description
+    // This function sets the resource limits of options on the process with
+    // PID pid, or on the calling process if pid is 0, with prlimit. The soft
+    // and hard limits are both set, so that the process can't raise them.
+    // It prints nothing, so that a forked child of scee can call it before
+    // execv.
+    //
+    // Returns
+    // limits_apply returns 0 on successful completion or -1, with errno set,
+    // in case of failure.
+
+    // variable declaration
+    struct rlimit limit;
+    int return_value;  // integer placeholder for error checking
+
+    if (options->rlimit_as > 0) {
+        limit.rlim_cur = limit.rlim_max = (rlim_t)options->rlimit_as;
+        return_value = prlimit(pid, RLIMIT_AS, &limit, NULL);
+        if (return_value == -1) {
+            return -1;
+        }
+    }
+    if (options->rlimit_cpu > 0) {
+        limit.rlim_cur = limit.rlim_max = (rlim_t)options->rlimit_cpu;
+        return_value = prlimit(pid, RLIMIT_CPU, &limit, NULL);
+        if (return_value == -1) {
+            return -1;
+        }
+    }
+    if (options->rlimit_nofile > 0) {
+        limit.rlim_cur = limit.rlim_max = (rlim_t)options->rlimit_nofile;
+        return_value = prlimit(pid, RLIMIT_NOFILE, &limit, NULL);
+        if (return_value == -1) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int cgroup_write(int dir_fd, const char *name, const char *value) {
+    // Description
+    // This function writes the string value to the file name of the cgroup
+    // directory dir_fd.
+    //
+    // Returns
+    // cgroup_write returns 0 on successful completion or -1 in case of
+    // failure, with errno set.
+
+    // variable declaration
+    ssize_t length;
+    int saved_errno;
+    int fd;
+
+    fd = openat(dir_fd, name, O_WRONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    length = write(fd, value, strlen(value));
+    saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+
+    return (length == (ssize_t)strlen(value)) ? 0 : -1;
+}
+
+int cgroup_enable(int dir_fd, const char *controller) {
+    // Description
+    // This function enables the controller controller for the children of
+    // the cgroup directory dir_fd, unless it already is.
+    //
+    // Returns
+    // cgroup_enable returns 1 if it enabled the controller, 0 if it already
+    // was, or -1 in case of failure.
+
+    // variable declaration
+    char controllers[256];
+    char *tokens[32];
+    ssize_t length;
+    int num_tokens;
+    int fd;
+    int i;  // generic counter
+
+    fd = openat(dir_fd, "cgroup.subtree_control", O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    length = read(fd, controllers, sizeof(controllers) - 1);
+    close(fd);
+    if (length == -1) {
+        return -1;
+    }
+    controllers[length] = '\0';
+    controllers[strcspn(controllers, "\n")] = '\0';
+
+    num_tokens = str_tokenize(controllers, tokens, 32);
+    for (i = 0; i < num_tokens; i++) {
+        if (!strcmp(tokens[i], controller)) {
+            return 0;
+        }
+    }
+
+    snprintf(controllers, sizeof(controllers), "+%s", controller);
+    if (cgroup_write(dir_fd, "cgroup.subtree_control", controllers) == -1) {
+        return -1;
+    }
+
+    return 1;
+}
+
+int cgroup_start() {
+    // Description
+    // This function looks for the cgroup v2 hierarchy and the cgroup of scee
+    // in it, and creates the cgroup scee-<pid> in it, in which the cgroups of
+    // the jobs are to be created. Outside of the root of the hierarchy,
+    // a cgroup with processes can't hand its controllers down, so scee first
+    // moves itself into a leaf, scee, shared by the instances of scee in
+    // the same cgroup. The memory and cpu controllers are then enabled down to
+    // the jobs. Failing to create the cgroups or to move scee means that
+    // the cgroup hasn't been delegated to scee, and that cgroups are
+    // unavailable. The controllers alone may be unavailable, in which case
+    // job_create falls back to the limits of every process.
+    //
+    // Returns
+    // cgroup_start returns 0 if cgroups are available or -1 otherwise.
+
+    // variable declaration
+    char line[4096];
+    char mount_point[4096];
+    char path[8192];
+    char pid[16];
+    const char *fields;
+    FILE *file;
+    int found;
+    int fd;
+
+    cgroups.started = 1;
+
+    // The mount point of the cgroup2 file system.
+    file = fopen("/proc/self/mountinfo", "re");
+    if (file == NULL) {
+        return -1;
+    }
+    found = 0;
+    while (!found && (fgets(line, sizeof(line), file) != NULL)) {
+        fields = strstr(line, " - cgroup2 ");
+        if (fields != NULL) {
+            found = (sscanf(skip_fields(line, 4), "%4095s", mount_point) == 1);
+        }
+    }
+    fclose(file);
+    if (!found) {
+        return -1;
+    }
+
+    // The cgroup of scee, on the line of the hierarchy 0.
+    file = fopen("/proc/self/cgroup", "re");
+    if (file == NULL) {
+        return -1;
+    }
+    found = 0;
+    while (!found && (fgets(line, sizeof(line), file) != NULL)) {
+        if (!strncmp(line, "0::", 3)) {
+            line[strcspn(line, "\n")] = '\0';
+            snprintf(path, sizeof(path), "%s%s", mount_point, line + 3);
+            found = 1;
+        }
+    }
+    fclose(file);
+    if (!found) {
+        return -1;
+    }
+
+    fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    cgroups.base_fd = fd;
+
+    if (strcmp(line + 3, "/")) {
+        snprintf(pid, sizeof(pid), "%d", (int)getpid());
+        if (((mkdirat(fd, "scee", 0755) == -1) && (errno != EEXIST)) ||
+                (cgroup_write(fd, "scee/cgroup.procs", pid) == -1)) {
+            cgroup_stop();
+            return -1;
+        }
+        cgroups.in_leaf = 1;
+    }
+    cgroups.memory_enabled = (cgroup_enable(fd, "memory") == 1);
+    cgroups.cpu_enabled = (cgroup_enable(fd, "cpu") == 1);
+
+    snprintf(cgroups.root_name, sizeof(cgroups.root_name), "scee-%d",
+            (int)getpid());
+    if (mkdirat(fd, cgroups.root_name, 0755) == 0) {
+        cgroups.root_fd = openat(fd, cgroups.root_name,
+                O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (cgroups.root_fd == -1) {
+            unlinkat(fd, cgroups.root_name, AT_REMOVEDIR);
+        }
+    }
+    if (cgroups.root_fd == -1) {
+        cgroup_stop();
         return -1;
     }
+    cgroup_enable(cgroups.root_fd, "memory");
+    cgroup_enable(cgroups.root_fd, "cpu");
 
     return 0;
 }
 
-int process_exec(process_t *processes, char *arguments[]) {
+void cgroup_stop() {
     // Description
-    // This function spawns a new process of the executable file specified in
-    // the path which is the first element of arguments and adds a node
-    // containing information about it in processes.
+    // This function undoes cgroup_start once the cgroups of all the jobs have
+    // been removed: it removes the cgroup of the jobs, and moves scee back
+    // out of the leaf, removing it, unless other instances of scee are in it.
+    // The controllers scee enabled are disabled first, since a cgroup with
+    // controllers enabled for its children can't have processes.
     //
     // Returns
-    // process_exec returns 0 on successful completion or -1 in case of failure.
+    // cgroup_stop does not return any value.
 
     // variable declaration
-    int pid; // TODO Should it be pid_t instead?
-    char path[MAX_PATH_LENGTH + 1];
-    struct timespec sleep_time;
-    int return_value;  // integer placeholder for error checking
+    char procs[64];
+    char pid[16];
+    ssize_t length;
+    int fd;
 
-    // process_exec requires a valid path.
-    if (arguments[0] == NULL) {
-        printf("error, " ANSI_BOLD "exec" ANSI_RESET " requires a valid PATH\n");
-        return 0;
+    if ((cgroups.base_fd == -1) || (cgroups.jobs != NULL)) {
+        return;
     }
 
-    sleep_time.tv_sec = SLEEP_SECONDS;
-    sleep_time.tv_nsec = (long)SLEEP_NANOSECONDS;
-
-    // Store the path to the executable file.
-    strcpy(path, arguments[0]);
+    if (cgroups.root_fd != -1) {
+        close(cgroups.root_fd);
+        cgroups.root_fd = -1;
+        unlinkat(cgroups.base_fd, cgroups.root_name, AT_REMOVEDIR);
+    }
 
-    // fork
-    return_value = (int)fork();
-    if (return_value == -1) {
-        perror("error, fork");
-        return -1;
-    } else if (return_value == 0) {
-        // child code
-        return_value = child_signal_handling();
-        if (return_value == -1) {
-            printf("error, child_signal_handling\n");
+    if (cgroups.in_leaf) {
+        // The leaf is left as it is if other processes are in it.
+        snprintf(pid, sizeof(pid), "%d\n", (int)getpid());
+        length = -1;
+        fd = openat(cgroups.base_fd, "scee/cgroup.procs", O_RDONLY | O_CLOEXEC);
+        if (fd != -1) {
+            length = read(fd, procs, sizeof(procs) - 1);
+            close(fd);
         }
-
-        return_value = execv(path, arguments);
-        if (return_value == -1) {
-            perror("error, execv");
-            exit(-1);
+        if ((length > 0) && ((size_t)length == strlen(pid)) &&
+                !strncmp(procs, pid, (size_t)length)) {
+            if (cgroups.memory_enabled) {
+                cgroup_write(cgroups.base_fd, "cgroup.subtree_control",
+                        "-memory");
+            }
+            if (cgroups.cpu_enabled) {
+                cgroup_write(cgroups.base_fd, "cgroup.subtree_control",
+                        "-cpu");
+            }
+            pid[strlen(pid) - 1] = '\0';
+            if (cgroup_write(cgroups.base_fd, "cgroup.procs", pid) == 0) {
+                unlinkat(cgroups.base_fd, "scee", AT_REMOVEDIR);
+            }
         }
-    } else {
-        // parent code
-        pid = return_value;
+    }
 
-        // Wait a short period of time before you check whether the child is
-        // still running. This could fail if the access to the file is too slow
-        // and, conceivably, for other reasons.
-        return_value = nanosleep(&sleep_time, NULL);
-        if (return_value == -1) {
-            perror("error, nanosleep");
-            return -1;
-        }
+    close(cgroups.base_fd);
+    cgroups.base_fd = -1;
+    cgroups.in_leaf = 0;
+    cgroups.memory_enabled = 0;
+    cgroups.cpu_enabled = 0;
+    cgroups.started = 0;
+}
 
-        // Perform error checking for sending a signal to the child process.
-        // http://stackoverflow.com/q/5460702
-        return_value = kill(pid, 0);
-        if (return_value == 0) {
-            // The process exists, the file probably executed successfully.
+job_t *job_create(exec_options_t *options, int count) {
+    // Description
+    // This function creates the job of the count processes about to be
+    // spawned with the options options, in a cgroup of its own, whose
+    // memory.max and cpu.max are set from the memory_max and cpu_max
+    // options. The limits that can't be set through the cgroup fall back to
+    // the limits of every process: memory_max to the address space limit,
+    // unless one is given, and cpu_max to a share of it for every process,
+    // enforced by the throttler, unless a CPU limit is given. options are
+    // updated accordingly.
+    //
+    // Returns
+    // job_create returns a pointer to the job, or NULL if neither option is
+    // given, if cgroups are unavailable, or in case of failure.
 
-            return_value = list_add(processes, pid, path);
-            if (return_value == -1) {
-                printf("error, list_add\n");
+    // variable declaration
+    char value[64];
+    job_t *job;
+    int memory_set;  // Boolean indicator that memory.max is set.
+    int cpu_set;  // Boolean indicator that cpu.max is set.
+
+    if ((options->memory_max == 0) && (options->cpu_max == 0)) {
+        return NULL;
+    }
+
+    if (!cgroups.started) {
+        cgroup_start();
+    }
+
+    job = NULL;
+    memory_set = 0;
+    cpu_set = 0;
+    if (cgroups.root_fd != -1) {
+        job = (job_t *)malloc(sizeof(job_t));
+        if (job == NULL) {
+            perror("error, malloc");
+            return NULL;
+        }
+        snprintf(job->name, sizeof(job->name), "job-%d", cgroups.num_created);
+        job->dir_fd = -1;
+        job->procs_fd = -1;
+        if (mkdirat(cgroups.root_fd, job->name, 0755) == 0) {
+            job->dir_fd = openat(cgroups.root_fd, job->name,
+                    O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        }
+        if (job->dir_fd != -1) {
+            job->procs_fd = openat(job->dir_fd, "cgroup.procs",
+                    O_WRONLY | O_CLOEXEC);
+        }
+        if (job->procs_fd == -1) {
+            perror("error, cgroup");
+            if (job->dir_fd != -1) {
+                close(job->dir_fd);
+                unlinkat(cgroups.root_fd, job->name, AT_REMOVEDIR);
             }
+            free(job);
+            job = NULL;
+        }
+    }
 
-            printf("a process with PID %d was spawned\n", pid);
-        } else if (errno == ESRCH) {
-            printf("error in executing the program, or the program exited");
-            printf(" instantly; nothing was added to the process list\n");
-        } else {
-            perror("error, kill");
-            return -1;
+    if (job != NULL) {
+        cgroups.num_created++;
+        job->num_processes = 0;
+        job->num_alive = 0;
+        job->num_selected = 0;
+        job->frozen = 0;
+        job->next = cgroups.jobs;
+        cgroups.jobs = job;
+
+        if (options->memory_max > 0) {
+            snprintf(value, sizeof(value), "%ld", options->memory_max);
+            memory_set = (cgroup_write(job->dir_fd, "memory.max", value) == 0);
+        }
+        if (options->cpu_max > 0) {
+            snprintf(value, sizeof(value), "%ld %d",
+                    (long)options->cpu_max * CGROUP_CPU_PERIOD_MICROSECONDS /
+                    100, CGROUP_CPU_PERIOD_MICROSECONDS);
+            cpu_set = (cgroup_write(job->dir_fd, "cpu.max", value) == 0);
         }
     }
 
-    return 0;
+    if ((options->memory_max > 0) && !memory_set) {
+        printf("memory.max is unavailable, the address space of every process"
+                " is limited instead\n");
+        if (options->rlimit_as == 0) {
+            options->rlimit_as = options->memory_max;
+        }
+    }
+    if ((options->cpu_max > 0) && !cpu_set) {
+        printf("cpu.max is unavailable, every process is throttled to its"
+                " share instead\n");
+        if (options->cpu_limit == 0) {
+            options->cpu_limit = (options->cpu_max / count > 0) ?
+                    options->cpu_max / count : 1;
+        }
+    }
+
+    return job;
 }
 
-int low_level_process_kill(process_t *process) {
+int job_attach(job_t *job, int pid) {
     // Description
-    // This function kills the process process and removes its node from
-    // the list it resides.
+    // This function moves the process with PID pid, or the calling process if
+    // pid is 0, into the cgroup of the job job.
     //
     // Returns
-    // low_level_process_kill returns 0 on successful completion
-    // or -1 in case of failure.
+    // job_attach returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
-    int return_value;  // integer placeholder for error checking
+    char string[16];
+    ssize_t length;
 
-    // kill the process.
-    return_value = kill((pid_t)process->pid, SIGTERM);
-    if (return_value == -1) {
-        perror("error, kill");
+    length = snprintf(string, sizeof(string), "%d", pid);
+    if (write(job->procs_fd, string, (size_t)length) != length) {
         return -1;
     }
 
-    // TODO
-    // I would like a check here of whether the process exists after several
-    // specified periods of time. If it does, it could be killed with
-    // kill((pid_t)process->pid, SIGKILL);
+    return 0;
+}
 
-    // Remove its node from the list.
-    return_value = list_remove(process);
-    if (return_value == -1) {
-        printf("error, list_remove\n");
-        return -1;
-    }
+void job_exited(process_t *process) {
+    // Description
+    // This function accounts for the exit of the process process in its job.
+    //
+    // Returns
+    // job_exited does not return any value.
 
-    return 0;
+    if (process->job != NULL) {
+        process->job->num_alive--;
+    }
 }
 
-int process_kill(process_t *processes, char *string_pid) {
+void job_release(process_t *process) {
     // Description
-    // This function kills the process with PID equal to pid, provided it
-    // exists in the list processes, and removes its node from it.
+    // This function removes the process process, which is about to leave
+    // the list, from its job. A frozen job is split first, so that its other
+    // processes stay stopped. The cgroup of a job left without processes is
+    // removed, once they have all exited, by job_collect.
     //
     // Returns
-    // process_kill returns 0 on successful completion or -1 in case of failure.
+    // job_release does not return any value.
 
     // variable declaration
-    int pid;
-    process_t *result;
-    int return_value;  // integer placeholder for error checking
+    job_t *job;
 
-    // process_kill requires a valid PID.
-    if (string_pid == NULL) {
-        printf("error, " ANSI_BOLD "kill" ANSI_RESET " requires a valid PID\n");
-        return 0;
+    job = process->job;
+    if (job == NULL) {
+        return;
     }
 
-    // Store the PID as an integer.
-    pid = atoi(string_pid);
+    if (job->frozen) {
+        job_split(job, process);
+    }
+    if (!process->exited) {
+        job->num_alive--;
+    }
+    job->num_processes--;
+    process->job = NULL;
 
-    // Search in list processes for a process with PID equal to pid.
-    return_value = list_search(processes, &result, pid);
-    if (return_value == -1) {
-        printf("error, list_search\n");
-        return -1;
-    } else if (return_value == 0) {
-        printf("no process with PID %d\n", pid);
-    } else {
-        return_value = low_level_process_kill(result);
-        if (return_value == -1) {
-            printf("error, low_level_process_kill\n");
-            return -1;
-        } else {
-            printf("the process with PID %d was killed\n", pid);
+    if (job->num_processes == 0) {
+        job_collect();
+    }
+}
+
+void job_collect() {
+    // Description
+    // This function removes the cgroups of the jobs left without processes.
+    // A cgroup can't be removed until the processes in it have exited, so
+    // the removal is retried every time processes are reaped.
+    //
+    // Returns
+    // job_collect does not return any value.
+
+    // variable declaration
+    job_t **link;
+    job_t *job;
+
+    link = &cgroups.jobs;
+    while (*link != NULL) {
+        job = *link;
+        if ((job->num_processes > 0) ||
+                (unlinkat(cgroups.root_fd, job->name, AT_REMOVEDIR) == -1)) {
+            link = &job->next;
+            continue;
         }
+        close(job->procs_fd);
+        close(job->dir_fd);
+        *link = job->next;
+        free(job);
+    }
+}
+
+int job_freeze(job_t *job, int frozen) {
+    // Description
+    // This function freezes the processes of the job job if frozen is true,
+    // or thaws them otherwise, with a single write to cgroup.freeze.
+    //
+    // Returns
+    // job_freeze returns 0 on successful completion or -1 in case of failure.
+
+    if (cgroup_write(job->dir_fd, "cgroup.freeze", frozen ? "1" : "0") == -1) {
+        perror("error, cgroup.freeze");
+        return -1;
     }
+    job->frozen = frozen;
 
     return 0;
 }
 
-int process_stop(process_t *processes, char *string_pid) {
+void job_split(job_t *job, process_t *process) {
     // Description
-    // This function stops the process with PID equal to pid, provided it
-    // exists in the list processes and isn't already stopped, and sets its
-    // stopped status to 1.
+    // This function turns the freezing of the job job back into the stopping
+    // of its processes one by one, found by walking the list from the node
+    // process, so that they can be signalled one by one. They are sent
+    // SIGSTOP while still frozen, which they handle as soon as they are
+    // thawed, before running any code. The process process itself, about to
+    // be resumed or removed, is left running, so that it can handle
+    // a SIGTERM.
     //
     // Returns
-    // process_stop returns 0 on successful completion or -1 in case of failure.
+    // job_split does not return any value.
 
     // variable declaration
-    int pid;
-    process_t *result;
-    process_t *process;
-    int return_value;  // integer placeholder for error checking
+    process_t *node;
 
-    // process_stop requires a valid PID.
-    if (string_pid == NULL) {
-        printf("error, " ANSI_BOLD "stop" ANSI_RESET " requires a valid PID\n");
+    for (node = process->next; node != process; node = node->next) {
+        if ((node->job == job) && !node->exited) {
+            send_signal(node->pid, SIGSTOP);
+        }
+    }
+
+    job_freeze(job, 0);
+}
+
+int jobs_freeze(selection_t *selection, int stop) {
+    // Description
+    // This function stops, if stop is true, or resumes otherwise, the jobs
+    // all of whose processes are in selection, by freezing or thawing their
+    // cgroups, and takes their processes out of selection, updating their
+    // nodes. A job is frozen only if all of its processes are running, and
+    // thawed only if it is frozen. Frozen jobs only partly resumed are split
+    // into stopped processes, to be resumed one by one.
+    //
+    // Returns
+    // jobs_freeze returns the number of processes frozen or thawed.
+
+    // variable declaration
+    process_t *node;
+    job_t *job;
+    int num_frozen;
+    int num_selected;
+    int i;  // generic counter
+
+    if (cgroups.jobs == NULL) {
         return 0;
     }
 
-    // Store the PID as an integer.
-    pid = atoi(string_pid);
+    // Count the processes of every job that can be frozen or thawed.
+    for (i = 0; i < selection->num_nodes; i++) {
+        node = selection->nodes[i];
+        job = node->job;
+        if ((job != NULL) && (stop ? !node->stopped : job->frozen)) {
+            job->num_selected++;
+        }
+    }
 
-    // Search in list processes for a process with PID equal to pid.
-    return_value = list_search(processes, &result, pid);
-    if (return_value == -1) {
-        printf("error, list_search\n");
-        return -1;
-    } else if (return_value == 0) {
-        printf("no process with PID %d\n", pid);
-    } else {
-        process = result;
-        if (!(process->stopped)) {
-            // Stop the process.
-            return_value = kill((pid_t)pid, SIGSTOP);
-            if (return_value == -1) {
-                perror("error, kill");
-                return -1;
+    // Freeze or thaw the whole jobs, then drop their processes.
+    num_frozen = 0;
+    num_selected = 0;
+    for (i = 0; i < selection->num_nodes; i++) {
+        node = selection->nodes[i];
+        job = node->job;
+        if ((job != NULL) && (job->num_selected == job->num_alive) &&
+                (stop ? !job->frozen : job->frozen)) {
+            if (job_freeze(job, stop) == -1) {
+                job->num_selected = 0;
             }
+        }
+        if ((job != NULL) && (job->num_selected == job->num_alive) &&
+                (job->frozen == stop)) {
+            node->stopped = stop;
+            if (stop) {
+                sched_detach(node, 0);
+                throttle_detach(node, 0);
+            } else {
+                sched_attach(node);
+                throttle_attach(node);
+            }
+            num_frozen++;
+            continue;
+        }
+        if ((job != NULL) && job->frozen && !stop) {
+            job_split(job, node);
+        }
+        selection->nodes[num_selected] = node;
+        num_selected++;
+    }
+    selection->num_nodes = num_selected;
 
-            // Set the stopped status of the process node to 1.
-            process->stopped = 1;
+    for (job = cgroups.jobs; job != NULL; job = job->next) {
+        job->num_selected = 0;
+    }
 
-            printf("the process with PID %d was stopped\n", pid);
-        } else {
-            printf("the process with PID %d is already stopped\n", pid);
+    return num_frozen;
+}
+
+void jobs_thaw() {
+    // Description
+    // This function thaws all the frozen jobs.
+    //
+    // Returns
+    // jobs_thaw does not return any value.
+
+    // variable declaration
+    job_t *job;
+
+    for (job = cgroups.jobs; job != NULL; job = job->next) {
+        if (job->frozen) {
+            job_freeze(job, 0);
         }
     }
-
-    return 0;
 }
 
-int process_cont(process_t *processes, char *string_pid) {
+scee_stats_t *stats_create(int *fd) {
     // Description
-    // This function resumes the process with PID equal to pid, provided it
-    // exists in the list processes and isn't already running, and sets its
-    // stopped status to 0.
+    // This function creates the statistics page of a process about to be
+    // spawned, as a memory file mapped by scee. The file descriptor of
+    // the file is stored in fd, to be passed to the process as SCEE_STATS_FD
+    // and closed by scee once the process has been spawned. The page starts
+    // with SCEE_STATS_CREATED, which scee_stats_open checks before mapping
+    // it.
     //
     // Returns
-    // process_cont returns 0 on successful completion or -1 in case of failure.
+    // stats_create returns a pointer to the statistics page or NULL in case of
+    // failure.
 
     // variable declaration
-    int pid;
-    process_t *result;
-    process_t *process;
+    scee_stats_t *stats;
+    unsigned int magic;
+    int memory_fd;
     int return_value;  // integer placeholder for error checking
 
-    // process_cont requires a valid PID.
-    if (string_pid == NULL) {
-        printf("error, " ANSI_BOLD "cont" ANSI_RESET " requires a valid PID\n");
-        return 0;
+    memory_fd = memfd_create("scee-stats", MFD_CLOEXEC);
+    if (memory_fd == -1) {
+        perror("error, memfd_create");
+        return NULL;
     }
 
-    // Store the PID as an integer.
-    pid = atoi(string_pid);
+    // dup2 onto the same descriptor doesn't clear close-on-exec, so the file
+    // must not be SCEE_STATS_FD itself.
+    if (memory_fd == SCEE_STATS_FD) {
+        *fd = fcntl(memory_fd, F_DUPFD_CLOEXEC, SCEE_STATS_FD + 1);
+        close(memory_fd);
+        if (*fd == -1) {
+            perror("error, fcntl");
+            return NULL;
+        }
+        memory_fd = *fd;
+    }
 
-    // Search in list processes for a process with PID equal to pid.
-    return_value = list_search(processes, &result, pid);
+    return_value = ftruncate(memory_fd, SCEE_STATS_SIZE);
     if (return_value == -1) {
-        printf("error, list_search\n");
-        return -1;
-    } else if (return_value == 0) {
-        printf("no process with PID %d\n", pid);
-    } else {
-        process = result;
-        if (process->stopped) {
-            // Resume the process.
-            return_value = kill((pid_t)pid, SIGCONT);
-            if (return_value == -1) {
-                perror("error, kill");
-                return -1;
-            }
+        perror("error, ftruncate");
+        close(memory_fd);
+        return NULL;
+    }
 
-            // Set the stopped status of the process node to 0.
-            process->stopped = 0;
+    // scee maps the page read-only, so the magic number is written through
+    // the file.
+    magic = SCEE_STATS_CREATED;
+    if (pwrite(memory_fd, &magic, sizeof(magic),
+            offsetof(scee_stats_t, magic)) != (ssize_t)sizeof(magic)) {
+        perror("error, pwrite");
+        close(memory_fd);
+        return NULL;
+    }
 
-            printf("the process with PID %d was resumed\n", pid);
-        } else {
-            printf("the process with PID %d is already running\n", pid);
-        }
+    stats = mmap(NULL, SCEE_STATS_SIZE, PROT_READ, MAP_SHARED, memory_fd, 0);
+    if (stats == MAP_FAILED) {
+        perror("error, mmap");
+        close(memory_fd);
+        return NULL;
     }
 
-    return 0;
+    *fd = memory_fd;
+
+    return stats;
 }
 
-int process_list(process_t *list) {
+char **stats_environment() {
     // Description
-    // This function prints a table with information about the spawned running
-    // processes. It contains the processes PID, their status, and the path
-    // used to execute the program. The obsolete entries of the processes
-    // no longer existing are removed.
+    // This function builds the environment of the processes spawned with
+    // a statistics page: the environment of scee, without the variable
+    // SCEE_STATS_ENV it may have inherited, and SCEE_STATS_ENV set to
+    // SCEE_STATS_FD. Only the array is allocated, the strings are those of
+    // environ. The variable is never set in the environment of scee itself,
+    // so the processes spawned without a page, and those spawned by other
+    // means, don't get it.
     //
     // Returns
-    // process_list returns 0 on successful completion or -1 in case of failure.
+    // stats_environment returns the environment, to be freed by the caller,
+    // or NULL in case of failure.
 
     // variable declaration
-    process_t *node;
-    char status[MAX_STATUS_LENGTH + 1];
-    int num_removed;  // The number of obsolete entries removed from the list.
-    int return_value;  // integer placeholder for error checking
-
-    if (list == NULL) {
-        // list should point to a valid list.
-        return -1;
+    static char variable[] = SCEE_STATS_ENV "=" STRINGIFY(SCEE_STATS_FD);
+    char **envp;
+    size_t num_variables;
+    size_t i;  // generic counter
+    size_t j;  // generic counter
+
+    num_variables = 0;
+    while (environ[num_variables] != NULL) {
+        num_variables++;
     }
 
-    // Check all entries of whether they are still current.
-    num_removed = 0;
-    for (node = list->next; node != list; node = node->next) {
-        // Perform error checking for sending a signal to the child process.
-        // http://stackoverflow.com/q/5460702
-        return_value = kill(node->pid, 0);
-        if (return_value == 0) {
-            // The process still exists.
-        } else if (errno == ESRCH) {
-            // The process doesn't exist.
-
-            // Remove its node from the list.
-            return_value = list_remove(node);
-            if (return_value == -1) {
-                printf("error, list_remove\n");
-                return -1;
-            }
+    envp = (char **)malloc((num_variables + 2) * sizeof(*envp));
+    if (envp == NULL) {
+        perror("error, malloc");
+        return NULL;
+    }
 
-            num_removed++;
-        } else {
-            perror("error, kill");
-            return -1;
+    j = 0;
+    for (i = 0; i < num_variables; i++) {
+        if (strncmp(environ[i], SCEE_STATS_ENV "=",
+                sizeof(SCEE_STATS_ENV)) != 0) {
+            envp[j++] = environ[i];
         }
     }
+    envp[j++] = variable;
+    envp[j] = NULL;
 
-    printf("\n");
+    return envp;
+}
 
-    // top border
-    printf("+-------------------");
-    printf("------------------------------------------------------------");
-    printf("\n");
+void stats_release(process_t *process) {
+    // Description
+    // This function unmaps the statistics page of the process process.
+    //
+    // Returns
+    // stats_release does not return any value.
 
-    // title
-    printf("|  spawned running processes\n");
+    if (process->stats == NULL) {
+        return;
+    }
 
-    // separator
-    printf("+-------+----------+");
-    printf("------------------------------------------------------------");
-    printf("\n");
+    munmap(process->stats, SCEE_STATS_SIZE);
+    process->stats = NULL;
+}
 
-    // table headers
-    printf("%c", '|');
-    printf("  PID  ");
-    printf("%c", '|');
-    printf("  status  ");
-    printf("%c", '|');
-    printf("  path  ");
-    printf("\n");
+int stats_read(const scee_stats_t *stats, scee_stats_t *copy) {
+    // Description
+    // This function copies the counters published in the statistics page
+    // stats into copy, retrying while the process is updating them.
+    //
+    // Returns
+    // stats_read returns 0 on successful completion or -1 if the process
+    // hasn't initialized the page.
 
-    // separator
-    printf("+-------+----------+");
-    printf("------------------------------------------------------------");
-    printf("\n");
+    // variable declaration
+    unsigned int sequence;
 
-    if (list->next == list) {
-        // empty entry
-        printf("|       |          |");
-        printf("        ");
-        printf("\n");
+    if (atomic_load_explicit(&stats->magic, memory_order_acquire) !=
+            SCEE_STATS_MAGIC) {
+        return -1;
     }
 
-    // process data
-    for (node = list->next; node != list; node = node->next) {
-        printf("%c", '|');
-        printf(" %5d ", node->pid);
-        printf("%c", '|');
-        if (node->stopped == 0) {
-            strcpy(status, "running");
-        } else {
-            strcpy(status, "stopped");
-        }
-        printf("  %s ", status);
-        printf("%c", '|');
-        printf(" %s ", node->path);
-        printf("\n");
-    }
+    do {
+        sequence = atomic_load_explicit(&stats->sequence, memory_order_acquire);
+        copy->pid = stats->pid;
+        memcpy(copy->name, stats->name, sizeof(copy->name));
+        copy->counter = stats->counter;
+        copy->delay = stats->delay;
+        copy->update_time = stats->update_time;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) ||
+            (sequence != atomic_load_explicit(&stats->sequence,
+            memory_order_relaxed)));
+    copy->name[SCEE_STATS_NAME_LENGTH] = '\0';
 
-    // bottom border
-    printf("+-------+----------+");
-    printf("------------------------------------------------------------");
-    printf("\n");
+    return 0;
+}
 
-    if (num_removed == 1) {
-        printf("\n1 obsolete process entry was removed\n\n");
-    } else if (num_removed > 1) {
-        printf("\n%d obsolete process entries were removed\n\n", num_removed);
+// The column that compare_usage sorts by, set by process_top.
+static int top_sort_column;
+
+int compare_usage(const void *a, const void *b) {
+    // Description
+    // This function compares the resource usage of the nodes pointed to by
+    // a and b in the column top_sort_column, for use with qsort. The PID is
+    // sorted in ascending order and the other columns in descending order.
+    //
+    // Returns
+    // compare_usage returns a negative value, 0, or a positive value, if a
+    // sorts before, equally to, or after b, respectively.
+
+    // variable declaration
+    const process_t *x = *(process_t * const *)a;
+    const process_t *y = *(process_t * const *)b;
+    double p;
+    double q;
+
+    switch (top_sort_column) {
+    case 0:
+        return (x->pid > y->pid) - (x->pid < y->pid);
+    case 1:
+        p = x->usage.cpu_percent;
+        q = y->usage.cpu_percent;
+        break;
+    case 2:
+        p = x->usage.rss;
+        q = y->usage.rss;
+        break;
+    case 3:
+        p = x->usage.context_switches;
+        q = y->usage.context_switches;
+        break;
+    default:
+        // The processes spawned first have the longest uptime.
+        p = y->usage.start_time;
+        q = x->usage.start_time;
+        break;
     }
 
-    return 0;
+    return (p < q) - (p > q);
 }
 
-int process_info(process_t *processes, char *string_pid) {
+int process_top(process_t *processes, char *arguments[]) {
     // Description
-    // This function sends the signal SIGUSR1 to the process with PID equal to
-    // pid, provided it exists in the list processes. It subsequently prints
-    // TODO information about the process.
-    //
-    // NOTE
-    // I'd prefer to implement this with the child sending back the signal
-    // SIGCHLD and having a handler for it in the parent. SIGCHLD fills in
-    // some elements of the sigaction struct providing information about
-    // the child.
+    // This function prints a table of the resource usage of the spawned
+    // processes: CPU usage over the last sampling interval, resident set
+    // size, context switches, and uptime. The samples of the running
+    // processes are taken from the sampler, the exited ones show the totals
+    // reported when they were reaped. The option "--sort COLUMN" of arguments
+    // sorts the table by pid, cpu (the default), rss, ctx, or uptime, and
+    // "--limit N" prints only the first N rows.
     //
     // Returns
-    // process_info returns 0 on successful completion or -1 in case of failure.
+    // process_top returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
-    int pid;
-    process_t *result;
-    int return_value;  // integer placeholder for error checking
+    static const char *columns[] = { "pid", "cpu", "rss", "ctx", "uptime" };
+    static buffer_t buffer;  // reused, so it rarely has to grow
+    static selection_t selection;  // reused, so it rarely has to grow
+    process_t *node;
+    usage_t usage;
+    char status[MAX_STATUS_LENGTH + 1];
+    const char *sort;
+    long now;
+    long uptime;
+    int limit;
+    int i;  // generic counter
 
-    // process_stop requires a valid PID.
-    if (string_pid == NULL) {
-        printf("error, " ANSI_BOLD "info" ANSI_RESET " requires a valid PID\n");
+    sort = "cpu";
+    for (i = 0; arguments[i] != NULL; i++) {
+        if (!strcmp(arguments[i], "--sort") && (arguments[i + 1] != NULL)) {
+            sort = arguments[i + 1];
+        }
+    }
+    for (top_sort_column = 0; top_sort_column < 5; top_sort_column++) {
+        if (!strcmp(sort, columns[top_sort_column])) {
+            break;
+        }
+    }
+    if (top_sort_column == 5) {
+        printf("error, " ANSI_BOLD "top" ANSI_RESET
+                " can sort by pid, cpu, rss, ctx, or uptime\n");
         return 0;
     }
-
-    // Store the PID as an integer.
-    pid = atoi(string_pid);
-
-    // Search in list processes for a process with PID equal to pid.
-    return_value = list_search(processes, &result, pid);
-    if (return_value == -1) {
-        printf("error, list_search\n");
-        return -1;
-    } else if (return_value == 0) {
-        printf("no process with PID %d\n", pid);
-    } else {
-        // Send the signal SIGUSR1 to the process.
-        return_value = kill((pid_t)pid, SIGUSR1);
-        if (return_value == -1) {
-            perror("error, kill");
+    limit = parse_option(arguments, "--limit", processes->index->length);
+
+    // Take the samples of the running processes from the sampler, or sample
+    // them directly if it hasn't sampled them yet.
+    now = monotonic_nanoseconds();
+    selection.num_nodes = 0;
+    for (node = processes->next; node != processes; node = node->next) {
+        if (!node->exited && (sampler_read(node, &usage) == 0)) {
+            node->usage.sample_time = usage.sample_time;
+            node->usage.cpu_time = usage.cpu_time;
+            node->usage.rss = usage.rss;
+            node->usage.context_switches = usage.context_switches;
+            node->usage.cpu_percent = usage.cpu_percent;
+        } else if (!node->exited) {
+            usage_sample(node, now);
+        }
+        if (selection_add(&selection, node) == -1) {
             return -1;
         }
     }
 
-    return 0;
+    qsort(selection.nodes, (size_t)selection.num_nodes,
+            sizeof(*selection.nodes), compare_usage);
+
+    buffer_printf(&buffer, "\n  PID   status     CPU%%     RSS KiB"
+            "      ctxsw    uptime  path\n");
+    for (i = 0; (i < selection.num_nodes) && (i < limit); i++) {
+        node = selection.nodes[i];
+        format_status(status, node);
+        uptime = (node->exited ? node->usage.end_time : now) -
+                node->usage.start_time;
+        buffer_printf(&buffer, "%5d  %-8s %6.1f  %10ld  %9ld  %7lds  %s\n",
+                node->pid, status, node->usage.cpu_percent, node->usage.rss,
+                node->usage.context_switches, uptime / 1000000000L,
+                node->path);
+    }
+
+    return buffer_write(&buffer, STDOUT_FILENO);
 }
 
-int process_quit(process_t *list) {
+// The table of the commands of scee, terminated by an empty entry.
+static const task_t tasks[] = {
+    { "exec", "e", process_exec, OPERATION_EXEC },
+    { "kill", "k", process_kill, OPERATION_KILL },
+    { "stop", "s", process_stop, OPERATION_STOP },
+    { "cont", "c", process_cont, OPERATION_CONT },
+    { "list", "l", process_list, OPERATION_LIST },
+    { "info", "i", process_info, OPERATION_INFO },
+    { "top", "t", process_top, OPERATION_TOP },
+    { "tail", "ta", process_tail, OPERATION_TAIL },
+    { "stats", "st", process_stats, OPERATION_STATS },
+    { "sched", "sc", process_sched, OPERATION_SCHED },
+    { "limit", "li", process_limit, OPERATION_LIMIT },
+    { "quit", "q", process_quit, OPERATION_QUIT },
+    { NULL, NULL, NULL, NUM_OPERATIONS }
+};
+
+const task_t *task_search(const char *name) {
     // Description
-    // This function kills all spawned processes that are still running.
-    //
-    // TODO There is no check here whether they are still running.
-    // This could be implemented by making a function, maybe named
-    // process_check, that does this check, that process_list could also use.
+    // This function searches for the command with name or abbreviation equal
+    // to name in the table tasks. Only the entries starting with the same
+    // character as name are compared in full.
     //
     // Returns
-    // process_quit returns 0 on successful completion or -1 in case of failure.
+    // task_search returns a pointer to the matching entry, or NULL if there
+    // is no such command.
 
     // variable declaration
-    process_t *node;
-    int return_value;  // integer placeholder for error checking
+    const task_t *task;
 
-    // kill all processes.
-    for (node = list->next; node != list; node = node->next) {
-        return_value = low_level_process_kill(node);
-        if (return_value == -1) {
-            printf("error, low_level_process_kill\n");
-            return -1;
+    for (task = tasks; task->name != NULL; task++) {
+        if (task->name[0] != name[0]) {
+            continue;
+        }
+        if (!strcmp(task->abbreviation, name) || !strcmp(task->name, name)) {
+            return task;
         }
     }
 
-    return 0;
+    return NULL;
 }
 
 int task_queue() {
     // Description
     // This function sets up the execution environment, prints the interface
     // of the application, and executes the tasks requested by the user.
+    // In batch mode the interface isn't printed. The end of the input is
+    // handled as a quit command.
     //
     // Returns
     // task_queue returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
     process_t *processes;
-    char *raw_input;
-    char **input;
-    char task[MAX_INPUT_LENGTH + 1];
-    const char space_tab[] = " \t";
+    static command_t command;  // too large for the stack of the loop
+    const task_t *task;
+    long start;
     int return_value;  // integer placeholder for error checking
-    int i;  // generic counter
 
-    // Clear the screen.
-    clear_screen();
+    if (!batch_mode) {
+        // Clear the screen.
+        clear_screen();
 
-    // Print a welcome message.
-    printf(ANSI_BOLD "SCEE" ANSI_RESET " - ");
-    printf(ANSI_RED "Signal Controlled Execution Environment" ANSI_RESET);
-    printf("\n");
+        // Print a welcome message.
+        printf(ANSI_BOLD "SCEE" ANSI_RESET " - ");
+        printf(ANSI_RED "Signal Controlled Execution Environment" ANSI_RESET);
+        printf("\n");
+    }
 
     // Create the processes list.
     processes = NULL;
@@ -1050,850 +7503,1257 @@ int task_queue() {
         return -1;
     }
 
-    strcpy(task, "");
-    while (strcmp(task, "quit") && strcmp(task, "q")) {
-        // Print available commands.
-        printf("\nCOMMANDS\n");
-        printf("    " ANSI_BOLD "exec" ANSI_RESET " <PATH> [arg1] [arg2] ...\n");
-        printf("    " ANSI_BOLD "kill" ANSI_RESET " <PID>\n");
-        printf("    " ANSI_BOLD "stop" ANSI_RESET " <PID>\n");
-        printf("    " ANSI_BOLD "cont" ANSI_RESET " <PID>\n");
-        printf("    " ANSI_BOLD "list" ANSI_RESET "\n");
-        printf("    " ANSI_BOLD "info" ANSI_RESET " <PID>\n");
-        printf("    " ANSI_BOLD "quit" ANSI_RESET "\n");
-        printf("> ");
+    // Start sampling the resource usage of the processes in the background.
+    return_value = sampler_start();
+    if (return_value == -1) {
+        printf("error, sampler_start\n");
+    }
+
+    // Start draining the output of the processes spawned with exec --capture.
+    return_value = capture_start();
+    if (return_value == -1) {
+        printf("error, capture_start\n");
+    }
+
+    do {
+        task = NULL;
+
+        if (!batch_mode) {
+            // Print available commands.
+            printf("\nCOMMANDS\n");
+            printf("    " ANSI_BOLD "exec" ANSI_RESET " [OPTIONS] [-n N] <PATH> [arg1] [arg2] ...\n");
+            printf("        OPTIONS: --capture, --log FILE,"
+                    " --cpu-limit PERCENT, --cpus LIST,\n");
+            printf("        --spread cpu|node, --membind, --rlimit-as SIZE,"
+                    " --rlimit-cpu SECONDS,\n");
+            printf("        --rlimit-nofile N, --memory-max SIZE,"
+                    " --cpu-max PERCENT\n");
+            printf("    " ANSI_BOLD "kill" ANSI_RESET " <PIDS>\n");
+            printf("    " ANSI_BOLD "stop" ANSI_RESET " <PIDS>\n");
+            printf("    " ANSI_BOLD "cont" ANSI_RESET " <PIDS>\n");
+            printf("        PIDS: PID, PID list and ranges (1,5-9), all,"
+                    " --path PATH, --group PGID\n");
+            printf("    " ANSI_BOLD "list" ANSI_RESET " [--offset M] [--limit N]\n");
+            printf("    " ANSI_BOLD "info" ANSI_RESET " <PID>|all\n");
+            printf("    " ANSI_BOLD "top" ANSI_RESET " [--sort pid|cpu|rss|ctx|uptime] [--limit N]\n");
+            printf("    " ANSI_BOLD "tail" ANSI_RESET " <PID> [N]\n");
+            printf("    " ANSI_BOLD "stats" ANSI_RESET " [--reset]\n");
+            printf("    " ANSI_BOLD "sched" ANSI_RESET " [on K [QUANTUM_MS] | off | weight PID W]\n");
+            printf("    " ANSI_BOLD "limit" ANSI_RESET " [PID PERCENT|off]\n");
+            printf("    " ANSI_BOLD "quit" ANSI_RESET "\n");
+            printf("> ");
+        }
 
         // Get a command.
-        raw_input = NULL;
-        return_value = get_input(&raw_input, MAX_INPUT_LENGTH);
+        return_value = read_command(stdin, &command);
         if (return_value == -1) {
-            printf("error, get_input\n");
+            if (!feof(stdin)) {
+                printf("error, read_command\n");
+                continue;
+            }
+
+            // The end of the input was reached, quit.
+            strcpy(command.line, "quit");
+            command.num_tokens = str_tokenize(command.line, command.tokens,
+                    MAX_TOKENS);
         }
 
-        input = NULL;
-        return_value = str_split(raw_input, &input, space_tab);
-        if (return_value == -1) {
-            printf("error, str_split\n");
+        if (command.num_tokens == 0) {
+            continue;
         }
 
-        if (strlen(raw_input) != 0) {
-            strcpy(task, input[0]);
-        } else {
-            strcpy(task, "");
-        }
-
-        // Execute the command.
-        if (!strcmp(task, "exec") || !strcmp(task, "e")) {
-            process_exec(processes, &input[1]);
-        } else if (!strcmp(task, "kill") || !strcmp(task, "k")) {
-            process_kill(processes, input[1]);
-        } else if (!strcmp(task, "stop") || !strcmp(task, "s")) {
-            process_stop(processes, input[1]);
-        } else if (!strcmp(task, "cont") || !strcmp(task, "c")) {
-            process_cont(processes, input[1]);
-        } else if (!strcmp(task, "list") || !strcmp(task, "l")) {
-            process_list(processes);
-        } else if (!strcmp(task, "info") || !strcmp(task, "i")) {
-            process_info(processes, input[1]);
-        } else if (!strcmp(task, "quit") || !strcmp(task, "q")) {
-            process_quit(processes);
-        } else if (!strcmp(task, "")) {
-        } else {
+        task = task_search(command.tokens[0]);
+        if (task == NULL) {
             printf("invalid command\n");
+            continue;
         }
 
-        // Memory deallocation.
-        free(raw_input);
-        for (i = 0; input[i] != NULL; i++) {
-            free(input[i]);
+        // Collect the child processes that have exited in the meantime.
+        return_value = process_reap(processes);
+        if (return_value == -1) {
+            printf("error, process_reap\n");
         }
-        free(input);
-    }
+
+        // Execute the command, recording its latency.
+        start = monotonic_nanoseconds();
+        task->function(processes, &command.tokens[1]);
+        histogram_record(&histograms[task->operation],
+                monotonic_nanoseconds() - start);
+    } while ((task == NULL) || (task->function != process_quit));
 
     return 0;
 }
-////////////////////////////////////////////////////////////////////////////////
 
-// tests
-////////////////////////////////////////////////////////////////////////////////
-int test_str_split() {
+int server_listen(const char *path) {
     // Description
-    // This function tests the str_split function.
+    // This function creates a Unix domain socket bound to path and listening
+    // for clients. A socket left at path by a previous run is replaced, any
+    // other file is left alone.
     //
     // Returns
-    // test_str_split returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
+    // server_listen returns the listening socket or -1 in case of failure.
 
     // variable declaration
-    char *string;
-    char **tokens;
-    char *delimiters;
-    char **expected_tokens;
-    const char space[] = " ";
-    //const char tab[] = "\t";  // not used yet
-    const char space_tab[] = " \t";
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
+    struct sockaddr_un address;
+    struct stat status;
+    int fd;
     int return_value;  // integer placeholder for error checking
-    void *return_pointer;  // pointer placeholder for error checking
-    int i;  // generic counter
-
-    printf("testing str_split\n");
 
-    num_tests = 0;
-    num_passed = 0;
-
-    // test 01
-    num_tests++;
-    failed = 0;
-
-    return_pointer = strdup("a");
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        printf("error, the socket path must be shorter than %zu characters\n",
+                sizeof(address.sun_path));
         return -1;
-    } else {
-        string = return_pointer;
     }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
 
-    return_pointer = strdup(space_tab);
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
+    if ((lstat(path, &status) == 0) && S_ISSOCK(status.st_mode)) {
+        unlink(path);
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("error, socket");
         return -1;
-    } else {
-        delimiters = return_pointer;
     }
 
-    expected_tokens = NULL;
-    return_pointer = (char **)realloc(expected_tokens,
-            (size_t)(1 * sizeof(*expected_tokens)));
-    if (return_pointer == NULL) {
-        perror("error, realloc");
-        // TODO_PRIME free memory
+    return_value = bind(fd, (struct sockaddr *)&address, sizeof(address));
+    if (return_value == -1) {
+        perror("error, bind");
+        close(fd);
         return -1;
-    } else {
-        expected_tokens = return_pointer;
     }
 
-    expected_tokens[0] = NULL;
-    return_pointer = strdup("a");
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
+    return_value = listen(fd, SERVER_BACKLOG);
+    if (return_value == -1) {
+        perror("error, listen");
+        close(fd);
+        unlink(path);
         return -1;
-    } else {
-        expected_tokens[0] = return_pointer;
     }
 
-    tokens = NULL;
-    return_value = str_split(string, &tokens, delimiters);
-    if (return_value != -1) {
-        for (i = 0; tokens[i] != NULL; i++) {
-            if (strcmp(tokens[i], expected_tokens[i])) {
-                failed = 1;
+    return fd;
+}
+
+int server_accept() {
+    // Description
+    // This function accepts all the pending connections on the listening
+    // socket of the server and polls the new clients for commands.
+    //
+    // Returns
+    // server_accept returns the number of clients accepted or -1 in case of
+    // failure.
+
+    // variable declaration
+    client_t *client;
+    client_t **clients;
+    struct epoll_event event;
+    int num_clients;
+    int num_accepted;
+    int fd;
+    int return_value;  // integer placeholder for error checking
+
+    num_accepted = 0;
+    for (;;) {
+        fd = accept4(server.listen_fd, NULL, NULL,
+                SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return num_accepted;
+            } else if ((errno == EINTR) || (errno == ECONNABORTED)) {
+                continue;
+            }
+            perror("error, accept4");
+            return -1;
+        }
+
+        if (fd >= server.num_clients) {
+            num_clients = server.num_clients > 0 ? server.num_clients : 64;
+            while (fd >= num_clients) {
+                num_clients *= 2;
+            }
+            clients = (client_t **)realloc(server.clients,
+                    (size_t)num_clients * sizeof(*clients));
+            if (clients == NULL) {
+                perror("error, realloc");
+                close(fd);
+                return -1;
             }
+            memset(&clients[server.num_clients], 0,
+                    (size_t)(num_clients - server.num_clients) *
+                    sizeof(*clients));
+            server.clients = clients;
+            server.num_clients = num_clients;
+        }
+
+        client = (client_t *)calloc(1, sizeof(*client));
+        if (client == NULL) {
+            perror("error, calloc");
+            close(fd);
+            return -1;
         }
-        if (!failed) {
-            num_passed++;
+        client->fd = fd;
+        client->events = EPOLLIN;
+
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        return_value = epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (return_value == -1) {
+            perror("error, epoll_ctl");
+            close(fd);
+            free(client);
+            return -1;
         }
+
+        server.clients[fd] = client;
+        num_accepted++;
     }
-    // TODO_PRIME free memory
+}
 
-    // test 02
-    num_tests++;
-    failed = 0;
+void server_close(client_t *client) {
+    // Description
+    // This function disconnects the client client, discarding its unsent
+    // responses, and deletes it. A command of client still waiting to
+    // complete has its output discarded.
+    //
+    // Returns
+    // server_close does not return any value.
 
-    return_pointer = strdup("a b c");
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
-        return -1;
-    } else {
-        string = return_pointer;
+    // variable declaration
+    info_wait_t *wait;
+
+    for (wait = server.info_waits; wait != NULL; wait = wait->next) {
+        if (wait->client == client) {
+            wait->client = NULL;
+        }
+    }
+    if (server.quit_client == client) {
+        server.quit_client = NULL;
     }
 
-    return_pointer = strdup(space);
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
-        return -1;
-    } else {
-        delimiters = return_pointer;
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    server.clients[client->fd] = NULL;
+    free(client->deferred_output.data);
+    free(client->output.data);
+    free(client);
+}
+
+int server_update(client_t *client) {
+    // Description
+    // This function polls the socket of client for more commands, unless
+    // the client has sent all its commands, a command of it waits to
+    // complete, or too many of its responses are still unsent, and for
+    // writing, while there are unsent responses.
+    //
+    // Returns
+    // server_update returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    struct epoll_event event;
+    size_t unsent;
+    int return_value;  // integer placeholder for error checking
+
+    unsent = client->output.length - client->output_sent;
+    event.events = 0;
+    if (!client->closing && !client->deferred &&
+            (unsent < CLIENT_OUTPUT_LIMIT)) {
+        event.events |= EPOLLIN;
+    }
+    if (unsent > 0) {
+        event.events |= EPOLLOUT;
+    }
+    if (event.events == client->events) {
+        return 0;
     }
 
-    expected_tokens = NULL;
-    return_pointer = (char **)realloc(expected_tokens,
-            (size_t)(3 * sizeof(*expected_tokens)));
-    if (return_pointer == NULL) {
-        perror("error, realloc");
-        // TODO_PRIME free memory
+    event.data.fd = client->fd;
+    return_value = epoll_ctl(server.epoll_fd, EPOLL_CTL_MOD, client->fd,
+            &event);
+    if (return_value == -1) {
+        perror("error, epoll_ctl");
         return -1;
-    } else {
-        expected_tokens = return_pointer;
     }
+    client->events = event.events;
 
-    expected_tokens[0] = NULL;
-    return_pointer = strdup("a");
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
-        return -1;
-    } else {
-        expected_tokens[0] = return_pointer;
+    return 0;
+}
+
+int server_flush(client_t *client) {
+    // Description
+    // This function sends as many of the responses to client as the socket
+    // accepts without blocking.
+    //
+    // Returns
+    // server_flush returns 0 on successful completion or -1 in case of
+    // failure, including the client having disconnected.
+
+    // variable declaration
+    ssize_t num_sent;
+
+    while (client->output_sent < client->output.length) {
+        num_sent = send(client->fd, client->output.data + client->output_sent,
+                client->output.length - client->output_sent, MSG_NOSIGNAL);
+        if (num_sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return 0;
+            }
+            return -1;
+        }
+        client->output_sent += num_sent;
     }
 
-    expected_tokens[1] = NULL;
-    return_pointer = strdup("b");
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
+    client->output.length = 0;
+    client->output_sent = 0;
+
+    return 0;
+}
+
+int server_settle(client_t *client) {
+    // Description
+    // This function sends what it can of the responses to client and
+    // updates what its socket is polled for. The client is disconnected once
+    // it has sent all its commands and received all the responses.
+    //
+    // Returns
+    // server_settle returns 0 on successful completion or -1 if the client
+    // was disconnected.
+
+    // variable declaration
+
+    if ((server_flush(client) == -1) || (client->closing && !client->deferred &&
+            (client->output.length == client->output_sent)) ||
+            (server_update(client) == -1)) {
+        server_close(client);
         return -1;
-    } else {
-        expected_tokens[1] = return_pointer;
     }
 
-    expected_tokens[2] = NULL;
-    return_pointer = strdup("c");
-    if (return_pointer == NULL) {
-        perror("error, strdup");
-        // TODO_PRIME free memory
-        return -1;
-    } else {
-        expected_tokens[2] = return_pointer;
+    return 0;
+}
+
+int server_execute(process_t *processes, char *line, const task_t **task) {
+    // Description
+    // This function executes the command line as task_queue would, its output
+    // going to the standard output, along with its error messages, and stores
+    // the executed command into task. A NULL line stands for a line that was
+    // too long.
+    //
+    // Returns
+    // server_execute returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    static char *tokens[MAX_TOKENS + 1];
+    FILE *error_stream;  // the standard error, restored after the command
+    long start;
+    int num_tokens;
+    int return_value;  // integer placeholder for error checking
+
+    *task = NULL;
+    if (line == NULL) {
+        printf("Error, the input was too large.");
+        printf(" Maximum permitted length: %d\n", MAX_INPUT_LENGTH);
+        return 0;
+    }
+
+    num_tokens = str_tokenize(line, tokens, MAX_TOKENS);
+    if (num_tokens == 0) {
+        return 0;
+    }
+
+    *task = task_search(tokens[0]);
+    if (*task == NULL) {
+        printf("invalid command\n");
+        return 0;
     }
 
-    tokens = NULL;
-    return_value = str_split(string, &tokens, delimiters);
-    if (return_value != -1) {
-        for (i = 0; tokens[i] != NULL; i++) {
-            if (strcmp(tokens[i], expected_tokens[i])) {
-                failed = 1;
+    // Execute the command, recording its latency.
+    error_stream = stderr;
+    stderr = stdout;
+    start = monotonic_nanoseconds();
+    return_value = (*task)->function(processes, &tokens[1]);
+    histogram_record(&histograms[(*task)->operation],
+            monotonic_nanoseconds() - start);
+    stderr = error_stream;
+
+    return return_value;
+}
+
+int server_process(client_t *client, process_t *processes) {
+    // Description
+    // This function executes the commands of client received in full, in
+    // order. The commands are executed in batches of up to
+    // MAX_BATCH_COMMANDS, the standard output being a memory file that
+    // collects the output of a whole batch, which is then appended to
+    // the responses to client. Every line gets a response, its length in
+    // bytes on a line of its own followed by the output of the command.
+    // A command that waits to complete, info or quit, keeps what it printed
+    // so far in deferred_output, and the next commands are executed once
+    // its response has been sent by server_respond.
+    //
+    // Returns
+    // server_process returns 1 if the client requested quit and it has
+    // completed, 0 on successful completion, or -1 in case of failure.
+
+    // variable declaration
+    static buffer_t batch_output;  // the output of a batch of commands
+    const task_t *task;
+    char *line;
+    char *newline;
+    size_t start;  // the beginning of the first unexecuted command in input
+    long length;
+    long end;  // the end of the output of the command waiting to complete
+    int num_commands;
+    int quit;  // Boolean indicator that quit was requested.
+    int i;  // generic counter
+
+    quit = 0;
+    start = 0;
+    do {
+        // Execute the commands of a batch, noting where the output of each
+        // of them ends. Anything printed between the commands is dropped.
+        fflush(stdout);
+        server.offsets[0] = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+        num_commands = 0;
+        while ((num_commands < MAX_BATCH_COMMANDS) && !quit &&
+                !client->deferred) {
+            newline = memchr(client->input + start, '\n',
+                    client->input_length - start);
+            if (newline == NULL) {
+                if (client->discarding) {
+                    start = client->input_length;
+                    break;
+                } else if ((start > 0) ||
+                        (client->input_length < CLIENT_INPUT_SIZE)) {
+                    break;
+                }
+
+                // The buffer is full without a complete command, the rest of
+                // the line is skipped.
+                client->discarding = 1;
+                newline = client->input + client->input_length - 1;
+                line = NULL;
+            } else if (client->discarding) {
+                client->discarding = 0;
+                start = newline - client->input + 1;
+                continue;
+            } else {
+                *newline = '\0';
+                line = client->input + start;
+                if (newline - line > MAX_INPUT_LENGTH) {
+                    line = NULL;
+                }
+            }
+            start = newline - client->input + 1;
+
+            server.current = client;
+            server_execute(processes, line, &task);
+            server.current = NULL;
+            if ((task != NULL) && (task->function == process_quit) &&
+                    !quitting.active && !client->deferred) {
+                quit = 1;
+            }
+
+            fflush(stdout);
+            if (client->deferred) {
+                // Keep what the command printed until it completes.
+                end = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+                length = end - server.offsets[num_commands];
+                client->deferred_output.length = 0;
+                if ((buffer_reserve(&client->deferred_output,
+                        (size_t)length) == -1) || ((length > 0) &&
+                        (pread(STDOUT_FILENO, client->deferred_output.data,
+                        (size_t)length, server.offsets[num_commands]) !=
+                        length))) {
+                    perror("error, pread");
+                    return -1;
+                }
+                client->deferred_output.length = (size_t)length;
+                break;
+            }
+            num_commands++;
+            server.offsets[num_commands] = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+            if (server.offsets[num_commands] == -1) {
+                perror("error, lseek");
+                return -1;
             }
         }
-        if (!failed) {
-            num_passed++;
+        if (num_commands == 0) {
+            lseek(STDOUT_FILENO, 0, SEEK_SET);
+            break;
+        }
+
+        // Read back the output of the batch and frame it into responses.
+        length = server.offsets[num_commands] - server.offsets[0];
+        batch_output.length = 0;
+        if (buffer_reserve(&batch_output, (size_t)length) == -1) {
+            return -1;
+        }
+        if ((length > 0) && (pread(STDOUT_FILENO, batch_output.data,
+                (size_t)length, server.offsets[0]) != length)) {
+            perror("error, pread");
+            return -1;
+        }
+        lseek(STDOUT_FILENO, 0, SEEK_SET);
+
+        if (buffer_reserve(&client->output, (size_t)length +
+                (size_t)num_commands * 16) == -1) {
+            return -1;
+        }
+        for (i = 0; i < num_commands; i++) {
+            length = server.offsets[i + 1] - server.offsets[i];
+            buffer_printf(&client->output, "%ld\n", length);
+            memcpy(client->output.data + client->output.length,
+                    batch_output.data + server.offsets[i] - server.offsets[0],
+                    (size_t)length);
+            client->output.length += length;
         }
-    }
-    // TODO_PRIME free memory
+    } while (!quit && !client->deferred);
 
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
-        return -1;
-    }
+    // Keep the incomplete command for the next read.
+    memmove(client->input, client->input + start, client->input_length - start);
+    client->input_length -= start;
+
+    return quit;
 }
 
-int test_list_create() {
+int server_serve(client_t *client, process_t *processes) {
     // Description
-    // This function tests the list_create function.
+    // This function reads the commands sent by client and executes those
+    // received in full with server_process.
     //
     // Returns
-    // test_list_create returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
+    // server_serve returns 1 if the client requested quit and it has
+    // completed, 0 on successful completion, or -1 in case of failure,
+    // including the client having disconnected.
 
     // variable declaration
-    process_t *list;
-    process_t expected_list;
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
-    int return_value;  // integer placeholder for error checking
-
-    printf("testing list_create\n");
+    ssize_t num_read;
 
-    num_tests = 0;
-    num_passed = 0;
-
-    // test 01
-    num_tests++;
-    failed = 0;
-
-    // expected_list initialization.
-    expected_list.pid = 0;
-    expected_list.path = NULL;
-    expected_list.stopped = 0;
-    expected_list.next = NULL;
-    expected_list.previous = NULL;
-
-    list = NULL;
-    return_value = list_create(&list);
-    if (return_value != -1) {
-        if ((list == NULL) ||
-                (list->pid != expected_list.pid) ||
-                (list->path != expected_list.path) ||
-                (list->stopped != expected_list.stopped) ||
-                (list->next != list) ||
-                (list->previous != list)) {
-            failed = 1;
+    num_read = read(client->fd, client->input + client->input_length,
+            CLIENT_INPUT_SIZE - client->input_length);
+    if (num_read == -1) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+            return 0;
         }
-        if (!failed) {
-            num_passed++;
+        return -1;
+    } else if (num_read == 0) {
+        // The last command may lack a newline character.
+        client->closing = 1;
+        if ((client->input_length > 0) &&
+                (client->input_length < CLIENT_INPUT_SIZE)) {
+            client->input[client->input_length++] = '\n';
         }
     }
-    // TODO_PRIME free memory
+    client->input_length += num_read;
 
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
-        return -1;
-    }
+    return server_process(client, processes);
 }
 
-int test_list_add() {
+int server_wait_info(info_request_t *requests, int num_requests,
+        int num_pending, int all) {
     // Description
-    // This function tests the list_add function.
+    // This function makes the info command being executed for the current
+    // client wait for the num_pending replies to its requests, sorted by PID,
+    // in the server loop rather than blocking it. The requests are taken
+    // over, and reported by server_complete.
     //
     // Returns
-    // test_list_add returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
+    // server_wait_info returns 0 on successful completion or -1 in case of
+    // failure, in which case requests is left to the caller.
 
     // variable declaration
-    process_t *list;
-    int pid;
-    char path[MAX_PATH_LENGTH + 1];
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
-    int return_value;  // integer placeholder for error checking
-
-    printf("testing list_add\n");
-
-    num_tests = 0;
-    num_passed = 0;
-
-    // test 01
-    num_tests++;
-    failed = 0;
+    info_wait_t *wait;
+    char *path;
+    int i;  // generic counter
 
-    list = NULL;
-    return_value = list_create(&list);
-    if (return_value == -1) {
-        printf("error, list_create\n");
+    wait = (info_wait_t *)malloc(sizeof(*wait));
+    if (wait == NULL) {
+        perror("error, malloc");
         return -1;
     }
 
-    pid = 1;
-    strcpy(path, "./program");
-    return_value = list_add(list, pid, path);
-    if (return_value != -1) {
-        if ((list->next->pid != pid) ||
-                (strcmp(list->next->path, path)) ||
-                (list->next->stopped != 0) ||
-                (list->next->next != list) ||
-                (list->next->previous != list)) {
-            failed = 1;
-        }
-        if ((list->previous->pid != pid) ||
-                (strcmp(list->previous->path, path)) ||
-                (list->previous->stopped != 0) ||
-                (list->previous->next != list) ||
-                (list->previous->previous != list)) {
-            failed = 1;
-        }
-        if (!failed) {
-            num_passed++;
+    // The paths are kept interned, as the processes may be removed before
+    // the replies arrive.
+    for (i = 0; i < num_requests; i++) {
+        path = path_intern(requests[i].path);
+        if (path == NULL) {
+            while (i-- > 0) {
+                path_release((char *)requests[i].path);
+            }
+            free(wait);
+            return -1;
         }
+        requests[i].path = path;
     }
-    // TODO_PRIME free memory
 
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
-        return -1;
-    }
+    wait->client = server.current;
+    wait->requests = requests;
+    wait->num_requests = num_requests;
+    wait->num_pending = num_pending;
+    wait->all = all;
+    clock_gettime(CLOCK_MONOTONIC, &wait->start);
+    wait->next = server.info_waits;
+    server.info_waits = wait;
+    server.current->deferred = 1;
+
+    return 0;
 }
 
-int test_list_remove() {
+int server_wait_quit() {
     // Description
-    // This function tests the list_remove function.
+    // This function makes the quit command being executed for the current
+    // client wait for the processes to exit in the server loop rather than
+    // blocking it. quit is then completed by server_complete.
     //
     // Returns
-    // test_list_remove returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
+    // server_wait_quit returns 0 on successful completion.
 
     // variable declaration
-    process_t *list;
-    process_t *result;
-    int pid;
-    char path[MAX_PATH_LENGTH + 1];
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
-    int return_value;  // integer placeholder for error checking
-
-    printf("testing list_remove\n");
-
-    num_tests = 0;
-    num_passed = 0;
-
-    list = NULL;
-    return_value = list_create(&list);
-    if (return_value == -1) {
-        printf("error, list_create\n");
-        return -1;
-    }
-
-    pid = 1;
-    strcpy(path, "./program");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
 
-    pid = 10;
-    strcpy(path, "./program_prime");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
+    server.quit_waiting = 1;
+    server.quit_client = server.current;
+    server.current->deferred = 1;
 
-    pid = 100;
-    strcpy(path, "./program_double_prime");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
+    return 0;
+}
 
-    pid = 1000;
-    strcpy(path, "./program_triple_prime");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
+int server_respond(client_t *client, long start) {
+    // Description
+    // This function appends to the responses to client the response to its
+    // command that waited to complete, made of what the command printed
+    // before waiting and what was printed to the standard output from start
+    // on. The output is discarded if client is NULL.
+    //
+    // Returns
+    // server_respond returns 0 on successful completion or -1 in case of
+    // failure.
 
-    // test 01
-    num_tests++;
-    failed = 0;
+    // variable declaration
+    long length;
+    int return_value;  // integer placeholder for error checking
 
-    pid = 1;
-    return_value = list_search(list, &result, pid);
-    if (return_value == -1) {
-        printf("error, list_search\n");
-    }
-    return_value = list_remove(result);
-    if (return_value != -1) {
-        return_value = list_search(list, &result, pid);
-        if (return_value == -1) {
-            printf("error, list_search\n");
-        }
-        if (return_value != 0) {
-            failed = 1;
+    fflush(stdout);
+    length = lseek(STDOUT_FILENO, 0, SEEK_CUR) - start;
+    return_value = 0;
+    if ((client != NULL) && (length >= 0)) {
+        client->deferred = 0;
+        if (buffer_reserve(&client->deferred_output, (size_t)length) == -1) {
+            return_value = -1;
+        } else if ((length > 0) &&
+                (pread(STDOUT_FILENO, client->deferred_output.data +
+                client->deferred_output.length, (size_t)length, start) !=
+                length)) {
+            perror("error, pread");
+            return_value = -1;
+        } else {
+            client->deferred_output.length += length;
+            buffer_printf(&client->output, "%zu\n",
+                    client->deferred_output.length);
+            if (buffer_reserve(&client->output,
+                    client->deferred_output.length) == -1) {
+                return_value = -1;
+            } else {
+                memcpy(client->output.data + client->output.length,
+                        client->deferred_output.data,
+                        client->deferred_output.length);
+                client->output.length += client->deferred_output.length;
+            }
         }
-    } else {
-        failed = 1;
+        client->deferred_output.length = 0;
     }
-    if (!failed) {
-        num_passed++;
-    }
-
-    // TODO_PRIME free memory
+    lseek(STDOUT_FILENO, 0, SEEK_SET);
 
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
-        return -1;
-    }
+    return return_value;
 }
 
-int test_list_print() {
+int server_complete(process_t *processes) {
     // Description
-    // This function tests the list_print function.
+    // This function completes the info commands whose replies have all
+    // arrived or whose INFO_TIMEOUT_MILLISECONDS have passed, and quit once
+    // the processes have been reaped or QUIT_TIMEOUT_MILLISECONDS have
+    // passed. The response of each is sent to its client, whose next
+    // commands are then executed.
     //
     // Returns
-    // test_list_print returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
+    // server_complete returns 1 if quit has completed, 0 on successful
+    // completion, or -1 in case of failure.
 
     // variable declaration
-    process_t *list;
-    int pid;
-    char path[MAX_PATH_LENGTH + 1];
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
+    info_wait_t *done;  // the info commands completed
+    info_wait_t *wait;
+    info_wait_t **link;
+    client_t *client;
+    FILE *error_stream;  // the standard error, restored after the reports
+    long start;
+    int quit;  // Boolean indicator that quit has completed.
     int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
 
-    printf("testing list_print\n");
-
-    num_tests = 0;
-    num_passed = 0;
+    // Take the completed info commands out of the list first, as executing
+    // the next commands of their clients may add new ones.
+    done = NULL;
+    link = &server.info_waits;
+    while (*link != NULL) {
+        wait = *link;
+        if ((wait->num_pending > 0) && (elapsed_nanoseconds(&wait->start) <
+                INFO_TIMEOUT_MILLISECONDS * 1000000L)) {
+            link = &wait->next;
+            continue;
+        }
+        *link = wait->next;
+        wait->next = done;
+        done = wait;
+    }
 
-    // test 01
-    num_tests++;
-    failed = 0;
+    return_value = 0;
+    quit = 0;
+    error_stream = stderr;
+    stderr = stdout;
+    while (done != NULL) {
+        wait = done;
+        done = wait->next;
+        client = wait->client;
+
+        fflush(stdout);
+        start = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+        info_report(processes, wait->requests, wait->num_requests, wait->all);
+        if (server_respond(client, start) == -1) {
+            return_value = -1;
+        }
 
-    list = NULL;
-    return_value = list_create(&list);
-    if (return_value == -1) {
-        printf("error, list_create\n");
-        return -1;
-    }
+        // Memory deallocation.
+        for (i = 0; i < wait->num_requests; i++) {
+            path_release((char *)wait->requests[i].path);
+        }
+        free(wait->requests);
+        free(wait);
 
-    pid = 1;
-    strcpy(path, "./program");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
+        if ((client != NULL) && (server_process(client, processes) == 1)) {
+            quit = 1;
+        }
+        if (client != NULL) {
+            server_settle(client);
+        }
     }
 
-    pid = 10;
-    strcpy(path, "./program_prime");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
+    if (server.quit_waiting && ((quitting.num_running <= 0) ||
+            (elapsed_nanoseconds(&quitting.start) >=
+            QUIT_TIMEOUT_MILLISECONDS * 1000000L))) {
+        server.quit_waiting = 0;
+        fflush(stdout);
+        start = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+        quit_finish(processes);
+        if (server_respond(server.quit_client, start) == -1) {
+            return_value = -1;
+        }
+        if (server.quit_client != NULL) {
+            server_settle(server.quit_client);
+            server.quit_client = NULL;
+        }
+        quit = 1;
     }
+    stderr = error_stream;
 
-    pid = 100;
-    strcpy(path, "./program_double_prime");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
+    return quit ? 1 : return_value;
+}
 
-    pid = 1000;
-    strcpy(path, "./program_triple_prime");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
+int server_timeout() {
+    // Description
+    // This function computes how long the server loop may wait for events
+    // before a command waiting to complete times out.
+    //
+    // Returns
+    // server_timeout returns the timeout in milliseconds, or -1 if no
+    // command is waiting.
 
-    return_value = list_print(list);
-    if (return_value == -1) {
-        failed = 1;
+    // variable declaration
+    info_wait_t *wait;
+    long remaining;
+    long timeout;
+
+    timeout = -1;
+    for (wait = server.info_waits; wait != NULL; wait = wait->next) {
+        remaining = INFO_TIMEOUT_MILLISECONDS -
+                elapsed_nanoseconds(&wait->start) / 1000000;
+        if ((timeout == -1) || (remaining < timeout)) {
+            timeout = remaining;
+        }
     }
-    // TODO_PRIME free memory
-
-    if (!failed) {
-        num_passed++;
+    if (server.quit_waiting) {
+        remaining = QUIT_TIMEOUT_MILLISECONDS -
+                elapsed_nanoseconds(&quitting.start) / 1000000;
+        if ((timeout == -1) || (remaining < timeout)) {
+            timeout = remaining;
+        }
     }
-
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
+    if (timeout == -1) {
         return -1;
     }
+
+    // Round up, so that the deadline has passed when the wait ends.
+    return timeout > 0 ? (int)timeout + 1 : 0;
 }
 
-int test_list_search() {
+int server_run(const char *path) {
     // Description
-    // This function tests the list_search function.
+    // This function runs scee in daemon mode. The commands are received
+    // through the Unix domain socket path from any number of clients, which
+    // may send many commands without waiting for the responses. A single
+    // thread waits with epoll for clients, commands, exited processes, and
+    // the replies to info. The commands that wait, info and quit, complete in
+    // the loop, so that the other clients are served in the meantime. The
+    // output of the spawned processes goes to the original standard output,
+    // the output of the commands and their error messages to the clients.
+    // The daemon stops when a client requests quit.
     //
     // Returns
-    // test_list_search returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
+    // server_run returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
-    process_t *list;
-    process_t *result;
-    int pid;
-    char path[MAX_PATH_LENGTH + 1];
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
+    struct epoll_event events[MAX_SERVER_EVENTS];
+    struct epoll_event event;
+    struct signalfd_siginfo siginfo[64];
+    process_t *processes;
+    client_t *client;
+    info_wait_t *wait;
+    ssize_t num_read;
+    int output_fd;  // the memory file that replaces the standard output
+    int num_events;
+    int quit;  // Boolean indicator that quit was requested.
+    int fd;
     int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
 
-    printf("testing list_search\n");
-
-    num_tests = 0;
-    num_passed = 0;
+    batch_mode = 1;
+    server.path = path;
 
-    list = NULL;
-    return_value = list_create(&list);
-    if (return_value == -1) {
-        printf("error, list_create\n");
+    server.listen_fd = server_listen(path);
+    if (server.listen_fd == -1) {
+        printf("error, server_listen\n");
         return -1;
     }
 
-    pid = 1;
-    strcpy(path, "./program");
-    return_value = list_add(list, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
+    // Keep the standard output above the descriptor of the statistics page,
+    // which the spawned processes receive in its place.
+    terminal_fd = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, SCEE_STATS_FD + 1);
+    if (terminal_fd == -1) {
+        perror("error, fcntl");
+        return -1;
+    }
+    output_fd = memfd_create("scee-output", MFD_CLOEXEC);
+    if (output_fd == -1) {
+        perror("error, memfd_create");
+        return -1;
+    }
+    fflush(stdout);
+    dup2(output_fd, STDOUT_FILENO);
+    close(output_fd);
+    setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+
+    server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (server.epoll_fd == -1) {
+        perror("error, epoll_create1");
+        return -1;
+    }
+    event.events = EPOLLIN;
+    event.data.fd = server.listen_fd;
+    epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &event);
+    if (sigchld_fd != -1) {
+        event.data.fd = sigchld_fd;
+        epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, sigchld_fd, &event);
+    }
+    if (info_fd != -1) {
+        event.data.fd = info_fd;
+        epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, info_fd, &event);
     }
 
-    pid = 10;
-    strcpy(path, "./program_prime");
-    return_value = list_add(list, pid, path);
+    // The same environment as task_queue sets up.
+    processes = NULL;
+    return_value = list_create(&processes);
     if (return_value == -1) {
-        printf("error, list_add\n");
+        printf("error, list_create\n");
+        return -1;
     }
-
-    pid = 100;
-    strcpy(path, "./program_double_prime");
-    return_value = list_add(list, pid, path);
+    return_value = sampler_start();
     if (return_value == -1) {
-        printf("error, list_add\n");
+        printf("error, sampler_start\n");
     }
-
-    pid = 1000;
-    strcpy(path, "./program_triple_prime");
-    return_value = list_add(list, pid, path);
+    return_value = capture_start();
     if (return_value == -1) {
-        printf("error, list_add\n");
+        printf("error, capture_start\n");
     }
 
-    // test 01
-    num_tests++;
-    failed = 0;
+    dprintf(terminal_fd, "scee listening on %s\n", path);
 
-    pid = 1;
-    return_value = list_search(list, &result, pid);
-    if (return_value == 1) {
-        if ((result == NULL) || (result->pid != pid)) {
-            failed = 1;
+    quit = 0;
+    while (!quit) {
+        num_events = epoll_wait(server.epoll_fd, events, MAX_SERVER_EVENTS,
+                server_timeout());
+        if (num_events == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("error, epoll_wait");
+            break;
         }
-    } else {
-        failed = 1;
-    }
-    if (!failed) {
-        num_passed++;
-    }
 
-    // test 02
-    num_tests++;
-    failed = 0;
+        for (i = 0; i < num_events; i++) {
+            fd = events[i].data.fd;
+            if (fd == server.listen_fd) {
+                if (server_accept() == -1) {
+                    printf("error, server_accept\n");
+                }
+                continue;
+            } else if (fd == sigchld_fd) {
+                return_value = process_reap(processes);
+                if (return_value == -1) {
+                    printf("error, process_reap\n");
+                } else if (quitting.active) {
+                    quitting.num_running -= return_value;
+                }
+                continue;
+            } else if (fd == info_fd) {
+                // Hand the replies to every info command waiting for them.
+                while ((num_read = read(info_fd, siginfo,
+                        sizeof(siginfo))) > 0) {
+                    for (wait = server.info_waits; wait != NULL;
+                            wait = wait->next) {
+                        wait->num_pending -= info_match(wait->requests,
+                                wait->num_requests, siginfo,
+                                (int)(num_read / (ssize_t)sizeof(siginfo[0])));
+                    }
+                }
+                continue;
+            }
+
+            client = server.clients[fd];
+            if (client == NULL) {
+                continue;
+            }
 
-    pid = 100;
-    return_value = list_search(list, &result, pid);
-    if (return_value == 1) {
-        if ((result == NULL) || (result->pid != pid)) {
-            failed = 1;
-        }
-    } else {
-        failed = 1;
-    }
-    if (!failed) {
-        num_passed++;
-    }
+            // A client that hung up while its socket isn't polled for
+            // commands can't receive its responses either.
+            if ((events[i].events & (EPOLLHUP | EPOLLERR)) &&
+                    !(client->events & EPOLLIN)) {
+                server_close(client);
+                continue;
+            }
 
-    // test 03
-    num_tests++;
-    failed = 0;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                return_value = 0;
+                if (client->events & EPOLLIN) {
+                    return_value = server_serve(client, processes);
+                }
+                if (return_value == -1) {
+                    server_close(client);
+                    continue;
+                } else if (return_value == 1) {
+                    quit = 1;
+                }
+            }
 
-    pid = 4;
-    return_value = list_search(list, &result, pid);
-    if (return_value != 0) {
-        failed = 1;
-    } else {
-        if (result != NULL) {
-            failed = 1;
+            server_settle(client);
         }
-    }
-    if (!failed) {
-        num_passed++;
-    }
 
-    // test 04
-    num_tests++;
-    failed = 0;
+        if (server_complete(processes) == 1) {
+            quit = 1;
+        }
+    }
 
-    pid = 111;
-    return_value = list_search(list, &result, pid);
-    if (return_value != 0) {
-        failed = 1;
-    } else {
-        if (result != NULL) {
-            failed = 1;
+    // Send what the sockets accept of the last responses and disconnect.
+    while (server.info_waits != NULL) {
+        wait = server.info_waits;
+        server.info_waits = wait->next;
+        for (i = 0; i < wait->num_requests; i++) {
+            path_release((char *)wait->requests[i].path);
         }
+        free(wait->requests);
+        free(wait);
     }
-    if (!failed) {
-        num_passed++;
+    for (fd = 0; fd < server.num_clients; fd++) {
+        if (server.clients[fd] != NULL) {
+            server_flush(server.clients[fd]);
+            server_close(server.clients[fd]);
+        }
     }
+    free(server.clients);
+    close(server.epoll_fd);
+    close(server.listen_fd);
+    unlink(path);
 
-    // TODO_PRIME free memory
+    // Restore the standard output.
+    fflush(stdout);
+    dup2(terminal_fd, STDOUT_FILENO);
+    close(terminal_fd);
+    terminal_fd = -1;
 
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
-        return -1;
-    }
+    // Memory deallocation.
+    index_delete(processes->index);
+    free(processes);
+
+    return 0;
 }
 
-int test_process_list() {
+void bench_report(const char *operation, int num_tracked, long *latencies,
+        int num_samples) {
     // Description
-    // This function tests the process_list function.
+    // This function prints the latency percentiles of the num_samples
+    // latencies, in nanoseconds, of the operation operation, measured with
+    // num_tracked processes tracked, as a tab separated line.
     //
     // Returns
-    // test_process_list returns 0 on successful completion of all tests or
-    // -1 in case of any test or itself failing.
-
-    // variable declaration
-    process_t *processes;
-    int pid;
-    char path[MAX_PATH_LENGTH + 1];
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
-    int failed;  // boolean indicator that a test failed
-    int return_value;  // integer placeholder for error checking
-
-    printf("testing process_list\n");
-
-    num_tests = 0;
-    num_passed = 0;
-
-    // test 01
-    num_tests++;
-    failed = 0;
-
-    // Create the processes list.
-    processes = NULL;
-    return_value = list_create(&processes);
-    if (return_value == -1) {
-        printf("error, list_create\n");
-        return -1;
-    }
-
-    pid = 1;
-    strcpy(path, "./program");
-    return_value = list_add(processes, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
-
-    pid = 1000;
-    strcpy(path, "./program_prime");
-    return_value = list_add(processes, pid, path);
-    if (return_value == -1) {
-        printf("error, list_add\n");
-    }
-
-    return_value = process_list(processes);
-    if (return_value == -1) {
-        failed = 1;
-    }
-    // TODO_PRIME free memory
+    // bench_report does not return any value.
 
-    if (!failed) {
-        num_passed++;
+    if (num_samples == 0) {
+        return;
     }
 
-    if (num_passed == num_tests) {
-        printf("\tall tests passed\n");
-        return 0;
-    } else {
-        printf("\tat least one test failed\n");
-        return -1;
-    }
+    qsort(latencies, (size_t)num_samples, sizeof(*latencies), compare_longs);
+    printf("%s\t%d\t%d\t%.1f\t%.1f\t%.1f\t%.1f\n", operation, num_tracked,
+            num_samples,
+            latencies[num_samples * 50 / 100] / 1000.0,
+            latencies[num_samples * 90 / 100] / 1000.0,
+            latencies[num_samples * 99 / 100] / 1000.0,
+            latencies[num_samples - 1] / 1000.0);
+    fflush(stdout);
 }
 
-int test_all() {
+int bench_operations(const int sizes[], int num_sizes) {
     // Description
-    // This function calls all the test functions of this program.
+    // This function measures the latency of the exec, stop, cont, kill, list,
+    // and quit commands with sizes[i] processes of BENCH_PROGRAM tracked, for
+    // each of the num_sizes sizes. exec spawns BENCH_SAMPLES more processes,
+    // which are then stopped, resumed, and killed one at a time. The output of
+    // the commands is discarded, and the percentiles of every command are
+    // printed as tab separated values with a header line, so that runs can be
+    // compared.
     //
     // Returns
-    // test_all returns 0 on successful completion of all test functions or
-    // -1 in case of any test function or itself failing.
+    // bench_operations returns 0 on successful completion or -1 in case of
+    // failure.
 
     // variable declaration
-    int num_tests;  // number of tests
-    int num_passed;  // number of tests passed
+    char *program[] = { BENCH_PROGRAM, BENCH_PROGRAM_ARGUMENT, NULL };
+    exec_options_t options;
+    char *no_arguments[] = { NULL };
+    char *arguments[2];
+    char string_pid[16];
+    process_t *processes;
+    long latencies[BENCH_SAMPLES];
+    int pids[BENCH_SAMPLES];
+    struct timespec start;
+    int stdout_fd;  // the original standard output
+    int null_fd;
+    int num_samples;
     int return_value;  // integer placeholder for error checking
+    int i, j;  // generic counters
 
-    num_tests = 0;
-    num_passed = 0;
-
-    // test_str_split
-    num_tests++;
-    return_value = test_str_split();
-    if (return_value == 0) {
-        num_passed++;
-    }
-
-    // test_list_create
-    num_tests++;
-    return_value = test_list_create();
-    if (return_value == 0) {
-        num_passed++;
-    }
+    memset(&options, 0, sizeof(options));
+    options.spread = SPREAD_NONE;
 
-    // test_list_add
-    num_tests++;
-    return_value = test_list_add();
-    if (return_value == 0) {
-        num_passed++;
+    processes = NULL;
+    return_value = list_create(&processes);
+    if (return_value == -1) {
+        fprintf(stderr, "error, list_create\n");
+        return -1;
     }
 
-    // test_list_remove
-    num_tests++;
-    return_value = test_list_remove();
-    if (return_value == 0) {
-        num_passed++;
+    // The output of the commands goes to /dev/null, the results to stdout.
+    fflush(stdout);
+    stdout_fd = dup(STDOUT_FILENO);
+    null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if ((stdout_fd == -1) || (null_fd == -1)) {
+        perror("error, open");
+        return -1;
     }
 
-    // test_list_print
-    num_tests++;
-    return_value = test_list_print();
-    if (return_value == 0) {
-        num_passed++;
-    }
+    printf("operation\ttracked\tsamples\tp50_us\tp90_us\tp99_us\tmax_us\n");
+    fflush(stdout);
+
+    arguments[0] = string_pid;
+    arguments[1] = NULL;
+
+    for (i = 0; i < num_sizes; i++) {
+        dup2(null_fd, STDOUT_FILENO);
+
+        // Spawn the tracked processes.
+        return_value = process_exec_bulk(processes, sizes[i], &options,
+                program);
+        if ((return_value == -1) || (processes->index->count != sizes[i])) {
+            fflush(stdout);
+            dup2(stdout_fd, STDOUT_FILENO);
+            fprintf(stderr, "error, only %d of %d processes were spawned\n",
+                    processes->index->count, sizes[i]);
+            process_quit(processes, no_arguments);
+            break;
+        }
 
-    // test_list_search
-    num_tests++;
-    return_value = test_list_search();
-    if (return_value == 0) {
-        num_passed++;
+        // exec
+        num_samples = 0;
+        for (j = 0; j < BENCH_SAMPLES; j++) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            return_value = process_exec(processes, program);
+            latencies[num_samples] = elapsed_nanoseconds(&start);
+            if ((return_value == 0) && (processes->next->pid != 0)) {
+                pids[num_samples] = processes->next->pid;
+                num_samples++;
+            }
+        }
+        fflush(stdout);
+        dup2(stdout_fd, STDOUT_FILENO);
+        bench_report("exec", sizes[i], latencies, num_samples);
+
+        // stop, cont, and kill, one process at a time
+        dup2(null_fd, STDOUT_FILENO);
+        for (j = 0; j < num_samples; j++) {
+            snprintf(string_pid, sizeof(string_pid), "%d", pids[j]);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            process_stop(processes, arguments);
+            latencies[j] = elapsed_nanoseconds(&start);
+        }
+        fflush(stdout);
+        dup2(stdout_fd, STDOUT_FILENO);
+        bench_report("stop", sizes[i], latencies, num_samples);
+
+        dup2(null_fd, STDOUT_FILENO);
+        for (j = 0; j < num_samples; j++) {
+            snprintf(string_pid, sizeof(string_pid), "%d", pids[j]);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            process_cont(processes, arguments);
+            latencies[j] = elapsed_nanoseconds(&start);
+        }
+        fflush(stdout);
+        dup2(stdout_fd, STDOUT_FILENO);
+        bench_report("cont", sizes[i], latencies, num_samples);
+
+        dup2(null_fd, STDOUT_FILENO);
+        for (j = 0; j < num_samples; j++) {
+            snprintf(string_pid, sizeof(string_pid), "%d", pids[j]);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            process_kill(processes, arguments);
+            latencies[j] = elapsed_nanoseconds(&start);
+        }
+        process_reap(processes);
+        fflush(stdout);
+        dup2(stdout_fd, STDOUT_FILENO);
+        bench_report("kill", sizes[i], latencies, num_samples);
+
+        // list
+        dup2(null_fd, STDOUT_FILENO);
+        for (j = 0; j < BENCH_LIST_SAMPLES; j++) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            process_list(processes, no_arguments);
+            latencies[j] = elapsed_nanoseconds(&start);
+        }
+        fflush(stdout);
+        dup2(stdout_fd, STDOUT_FILENO);
+        bench_report("list", sizes[i], latencies, BENCH_LIST_SAMPLES);
+
+        // quit, which also removes the processes before the next size
+        dup2(null_fd, STDOUT_FILENO);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        process_quit(processes, no_arguments);
+        latencies[0] = elapsed_nanoseconds(&start);
+        fflush(stdout);
+        dup2(stdout_fd, STDOUT_FILENO);
+        bench_report("quit", sizes[i], latencies, 1);
     }
 
-    //// test_process_list
-    //num_tests++;
-    //return_value = test_process_list();
-    //if (return_value == 0) {
-    //    num_passed++;
-    //}
+    // Memory deallocation.
+    close(null_fd);
+    close(stdout_fd);
+    index_delete(processes->index);
+    free(processes);
 
-    if (num_passed == num_tests) {
-        printf("\n");
-        printf("all tests passed\n");
-        return 0;
-    } else {
-        printf("\n");
-        printf("at least one test failed\n");
-        return -1;
-    }
+    return 0;
 }
 ////////////////////////////////////////////////////////////////////////////////
 
 // main function
 ////////////////////////////////////////////////////////////////////////////////
+#ifndef SCEE_NO_MAIN
+// The test binary, test_scee.c, includes this file without its main function.
 int main(int argc, char *argv[]) {
     // Description
     // The main function acts as a wrapper of the functions that implement
-    // the application functionality.
+    // the application functionality. If the option -b is given, followed by
+    // the path to a script, the commands are read from the script. If
+    // the option --daemon is given, followed by the path to a socket, scee
+    // runs in daemon mode, serving the clients connected to the socket. If
+    // the option --bench is given, followed by numbers of processes,
+    // 10, 1,000, and 10,000 by default, the commands are benchmarked with as
+    // many processes tracked instead.
     //
     // Returns
     // main returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
+    int sizes[BENCH_MAX_SIZES];  // the numbers of processes to benchmark with
+    int num_sizes;
     int return_value;  // integer placeholder for error checking
+    void *return_pointer;  // pointer placeholder for error checking
+    int i;  // generic counter
 
-    /*test_str_split();*/
-
-    /*test_list_create();*/
-
-    /*test_list_add();*/
-
-    /*test_list_remove();*/
+    if ((argc >= 2) && !strcmp(argv[1], "--bench")) {
+        num_sizes = 0;
+        for (i = 2; (i < argc) && (num_sizes < BENCH_MAX_SIZES); i++) {
+            sizes[num_sizes] = atoi(argv[i]);
+            if ((sizes[num_sizes] <= 0) ||
+                    (sizes[num_sizes] > MAX_BULK_SPAWNS)) {
+                printf("error, the numbers of processes must be in the range"
+                        " [1, %d]\n", MAX_BULK_SPAWNS);
+                return -1;
+            }
+            num_sizes++;
+        }
+        if (num_sizes == 0) {
+            sizes[0] = 10;
+            sizes[1] = 1000;
+            sizes[2] = 10000;
+            num_sizes = 3;
+        }
 
-    /*test_list_print();*/
+        // The same environment as task_queue sets up.
+        return_value = parent_signal_handling();
+        if (return_value == -1) {
+            printf("error, parent_signal_handling\n");
+            return -1;
+        }
+        return_value = sampler_start();
+        if (return_value == -1) {
+            printf("error, sampler_start\n");
+        }
 
-    /*test_list_search();*/
+        return bench_operations(sizes, num_sizes);
+    } else if ((argc == 3) && !strcmp(argv[1], "--daemon")) {
+        return_value = parent_signal_handling();
+        if (return_value == -1) {
+            printf("error, parent_signal_handling\n");
+            return -1;
+        }
 
-    /*test_process_list();*/
+        return server_run(argv[2]);
+    } else if ((argc == 3) && !strcmp(argv[1], "-b")) {
+        return_pointer = freopen(argv[2], "r", stdin);
+        if (return_pointer == NULL) {
+            perror("error, freopen");
+            return -1;
+        }
+    } else if (argc != 1) {
+        printf("usage: %s [-b SCRIPT | --daemon SOCKET | --bench [N ...]]\n",
+                argv[0]);
+        return -1;
+    }
 
-    /*test_all();*/
+    // Commands that don't come from a terminal are run in batch mode.
+    if (!isatty(STDIN_FILENO)) {
+        batch_mode = 1;
+    }
 
     return_value = parent_signal_handling();
     if (return_value == -1) {
@@ -1907,4 +8767,5 @@ int main(int argc, char *argv[]) {
 
     return 0;
 }
+#endif
 ////////////////////////////////////////////////////////////////////////////////
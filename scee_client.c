@@ -0,0 +1,268 @@
+// file scee_client.c
+////////////////////////////////////////////////////////////////////////////////
+// Description
+// A simple client of scee in daemon mode. It connects to the socket of scee,
+// sends it the command given as arguments, or else the commands read from
+// stdin, one per line, and prints the output of each command. The commands
+// read from stdin are sent as they are read, without waiting for
+// the responses to the previous ones.
+//
+// Every response of scee is the length of the output of a command on a line
+// of its own, followed by the output.
+////////////////////////////////////////////////////////////////////////////////
+
+// #include directives
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+////////////////////////////////////////////////////////////////////////////////
+
+// #define directives
+////////////////////////////////////////////////////////////////////////////////
+#define PROGRAM_DESCRIPTION "usage: scee_client SOCKET [COMMAND [ARGUMENT ...]]"
+
+#define BUFFER_SIZE 65536
+////////////////////////////////////////////////////////////////////////////////
+
+// custom data types
+////////////////////////////////////////////////////////////////////////////////
+struct response_s {
+    // This struct is the state of the parsing of the responses of scee.
+    long remaining;  // The bytes of output left, or -1 while in a length.
+    long length;  // The length being parsed.
+    long num_received;  // The number of complete responses.
+};
+typedef struct response_s response_t;
+////////////////////////////////////////////////////////////////////////////////
+
+// global variable declaration
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// function prototypes
+////////////////////////////////////////////////////////////////////////////////
+int client_connect(const char *path);
+void parse_responses(response_t *response, const char *data, size_t length);
+////////////////////////////////////////////////////////////////////////////////
+
+// functions
+////////////////////////////////////////////////////////////////////////////////
+int client_connect(const char *path) {
+    // Description
+    // This function connects to the Unix domain socket path.
+    //
+    // Returns
+    // client_connect returns the connected socket or -1 in case of failure.
+
+    // variable declaration
+    struct sockaddr_un address;
+    int fd;
+    int return_value;  // integer placeholder for error checking
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        printf("error, the socket path is too long\n");
+        return -1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        perror("error, socket");
+        return -1;
+    }
+
+    return_value = connect(fd, (struct sockaddr *)&address, sizeof(address));
+    if (return_value == -1) {
+        perror("error, connect");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+void parse_responses(response_t *response, const char *data, size_t length) {
+    // Description
+    // This function prints the output carried by the length bytes of data,
+    // received from scee, and counts the complete responses in response.
+    //
+    // Returns
+    // parse_responses does not return any value.
+
+    // variable declaration
+    size_t chunk;
+
+    while (length > 0) {
+        if (response->remaining == -1) {
+            // Parse the length of the output, one digit at a time.
+            if (*data == '\n') {
+                response->remaining = response->length;
+                response->length = 0;
+            } else {
+                response->length = response->length * 10 + (*data - '0');
+            }
+            data++;
+            length--;
+        } else {
+            chunk = length < (size_t)response->remaining ?
+                    length : (size_t)response->remaining;
+            fwrite(data, 1, chunk, stdout);
+            data += chunk;
+            length -= chunk;
+            response->remaining -= chunk;
+        }
+
+        if (response->remaining == 0) {
+            response->remaining = -1;
+            response->num_received++;
+        }
+    }
+}
+////////////////////////////////////////////////////////////////////////////////
+
+// main function
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    // Description
+    // The main function sends the commands to scee and prints their output.
+    // The socket is polled for both, and no more commands are read while
+    // the previous ones are still being sent, so that neither side blocks on
+    // a full socket.
+    //
+    // Returns
+    // main returns 0 on successful completion or 1 in case of failure.
+
+    // variable declaration
+    static char input[BUFFER_SIZE + 1];  // commands not sent yet
+    static char output[BUFFER_SIZE];  // responses received
+    response_t response = { -1, 0, 0 };
+    struct pollfd fds[2];
+    size_t input_length;
+    size_t input_sent;
+    long num_sent;  // the number of commands read, to be sent
+    int input_open;  // Boolean indicator that stdin has more commands
+    int last_newline;  // Boolean indicator that the input ended a line
+    ssize_t length;
+    int fd;
+    int return_value;  // integer placeholder for error checking
+    int i;  // generic counter
+
+    if (argc < 2) {
+        printf("%s\n", PROGRAM_DESCRIPTION);
+        return 1;
+    }
+
+    fd = client_connect(argv[1]);
+    if (fd == -1) {
+        return 1;
+    }
+
+    input_length = 0;
+    input_sent = 0;
+    num_sent = 0;
+    input_open = 1;
+    last_newline = 1;
+    if (argc > 2) {
+        // A single command given as arguments.
+        for (i = 2; i < argc; i++) {
+            length = snprintf(input + input_length,
+                    BUFFER_SIZE - input_length, "%s%s", argv[i],
+                    (i < argc - 1) ? " " : "\n");
+            if ((length < 0) || (input_length + length >= BUFFER_SIZE)) {
+                printf("error, the command is too long\n");
+                return 1;
+            }
+            input_length += length;
+        }
+        num_sent = 1;
+        input_open = 0;
+    }
+
+    while ((input_sent < input_length) || input_open ||
+            (response.num_received < num_sent)) {
+        fds[0].fd = (input_open && (input_sent == input_length)) ?
+                STDIN_FILENO : -1;
+        fds[0].events = POLLIN;
+        fds[1].fd = fd;
+        fds[1].events = POLLIN | ((input_sent < input_length) ? POLLOUT : 0);
+        return_value = poll(fds, 2, -1);
+        if (return_value == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("error, poll");
+            return 1;
+        }
+
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            length = read(fd, output, sizeof(output));
+            if (length == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("error, read");
+                return 1;
+            } else if (length == 0) {
+                // scee quit or closed the connection.
+                break;
+            }
+            parse_responses(&response, output, (size_t)length);
+        }
+
+        if (fds[1].revents & POLLOUT) {
+            length = send(fd, input + input_sent, input_length - input_sent,
+                    MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (length == -1) {
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+                        (errno != EINTR)) {
+                    perror("error, send");
+                    return 1;
+                }
+            } else {
+                input_sent += length;
+            }
+        }
+
+        if (fds[0].revents & (POLLIN | POLLHUP)) {
+            length = read(STDIN_FILENO, input, BUFFER_SIZE);
+            if (length == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                perror("error, read");
+                return 1;
+            }
+            if (length == 0) {
+                // The last command may lack a newline character.
+                input_open = 0;
+                if (!last_newline) {
+                    input[length++] = '\n';
+                }
+            }
+            for (i = 0; i < length; i++) {
+                if (input[i] == '\n') {
+                    num_sent++;
+                }
+            }
+            if (length > 0) {
+                last_newline = (input[length - 1] == '\n');
+            }
+            input_length = (size_t)length;
+            input_sent = 0;
+        }
+    }
+
+    fflush(stdout);
+    close(fd);
+
+    return 0;
+}
+////////////////////////////////////////////////////////////////////////////////
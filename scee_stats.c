@@ -0,0 +1,166 @@
+// file scee_stats.c
+////////////////////////////////////////////////////////////////////////////////
+// Description
+// The library used by the processes spawned by scee to publish their
+// statistics in the page shared with scee, or to reply with them to SIGUSR1,
+// as described in scee_stats.h.
+////////////////////////////////////////////////////////////////////////////////
+
+// #include directives
+////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "scee_stats.h"
+////////////////////////////////////////////////////////////////////////////////
+
+// global variable declaration
+////////////////////////////////////////////////////////////////////////////////
+static volatile sig_atomic_t scee_pid = 0;  // The PID of scee, if the process
+        // was spawned by it, set by scee_stats_open.
+////////////////////////////////////////////////////////////////////////////////
+
+// functions
+////////////////////////////////////////////////////////////////////////////////
+scee_stats_t *scee_stats_open(const char *name) {
+    // Description
+    // This function maps the statistics page passed by scee, if the process
+    // was spawned by scee, and initializes it with the PID of the process
+    // and name. It also records the PID of scee, for scee_info_reply, so it
+    // must be called even by processes that don't use the page. The file
+    // descriptor named by the environment is only used if it is a file of
+    // the size of a page starting with SCEE_STATS_CREATED, so that a stale
+    // variable doesn't make the process write to an unrelated file.
+    //
+    // Returns
+    // scee_stats_open returns a pointer to the statistics page, or NULL if
+    // the process wasn't spawned by scee or in case of failure. NULL can be
+    // passed to scee_stats_update, which then does nothing.
+
+    // variable declaration
+    scee_stats_t *stats;
+    struct stat status;
+    const char *value;
+    int fd;
+
+    value = getenv(SCEE_STATS_ENV);
+    if (value == NULL) {
+        return NULL;
+    }
+    fd = atoi(value);
+    scee_pid = (sig_atomic_t)getppid();
+
+    // The descendants of the process must not inherit the variable, even if
+    // the page can't be mapped.
+    unsetenv(SCEE_STATS_ENV);
+
+    if ((fstat(fd, &status) == -1) || !S_ISREG(status.st_mode) ||
+            (status.st_size != SCEE_STATS_SIZE)) {
+        return NULL;
+    }
+
+    stats = mmap(NULL, SCEE_STATS_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0);
+    if (stats == MAP_FAILED) {
+        return NULL;
+    }
+    if (atomic_load_explicit(&stats->magic, memory_order_relaxed) !=
+            SCEE_STATS_CREATED) {
+        munmap(stats, SCEE_STATS_SIZE);
+        return NULL;
+    }
+    close(fd);
+
+    stats->pid = (int)getpid();
+    strncpy(stats->name, name, SCEE_STATS_NAME_LENGTH);
+    stats->name[SCEE_STATS_NAME_LENGTH] = '\0';
+    atomic_store_explicit(&stats->magic, SCEE_STATS_MAGIC,
+            memory_order_release);
+
+    return stats;
+}
+
+void scee_stats_update(scee_stats_t *stats, long counter, long delay) {
+    // Description
+    // This function publishes counter and delay in the statistics page stats,
+    // along with the time of the update.
+    //
+    // Returns
+    // scee_stats_update does not return any value.
+
+    // variable declaration
+    struct timespec now;
+    unsigned int sequence;
+
+    if (stats == NULL) {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    sequence = atomic_load_explicit(&stats->sequence, memory_order_relaxed);
+    atomic_store_explicit(&stats->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    stats->counter = counter;
+    stats->delay = delay;
+    stats->update_time = now.tv_sec * 1000000000L + now.tv_nsec;
+    atomic_store_explicit(&stats->sequence, sequence + 2, memory_order_release);
+}
+
+int scee_info_reply(const siginfo_t *info, long counter, long delay) {
+    // Description
+    // This function replies to the SIGUSR1 described by info with the signal
+    // SCEE_INFO_SIGNAL carrying counter and delay, provided SIGUSR1 was sent
+    // by scee, as recorded by scee_stats_open. It is async-signal-safe, to be
+    // called from the handler of SIGUSR1 installed with SA_SIGINFO.
+    //
+    // Returns
+    // scee_info_reply returns 0 on successful completion or -1 if SIGUSR1
+    // wasn't sent by scee or in case of failure.
+
+    // variable declaration
+    union sigval value;
+
+    // Other senders, such as a shell, would be terminated by the reply.
+    if ((info == NULL) || (scee_pid == 0) || (info->si_pid != scee_pid)) {
+        return -1;
+    }
+
+    value.sival_int = SCEE_INFO_ENCODE(counter, delay);
+
+    return sigqueue(info->si_pid, SCEE_INFO_SIGNAL, value);
+}
+
+size_t scee_format_long(char *buffer, long value) {
+    // Description
+    // This function writes the decimal representation of the non negative
+    // value in buffer, without a terminating null character. Unlike
+    // snprintf, it is async-signal-safe.
+    //
+    // Returns
+    // scee_format_long returns the number of characters written.
+
+    // variable declaration
+    char digits[24];
+    size_t length;
+    size_t i;  // generic counter
+
+    length = 0;
+    do {
+        digits[length] = (char)('0' + value % 10);
+        value /= 10;
+        length++;
+    } while ((value > 0) && (length < sizeof(digits)));
+
+    for (i = 0; i < length; i++) {
+        buffer[i] = digits[length - 1 - i];
+    }
+
+    return length;
+}
+////////////////////////////////////////////////////////////////////////////////
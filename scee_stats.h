@@ -0,0 +1,76 @@
+// file scee_stats.h
+////////////////////////////////////////////////////////////////////////////////
+// Description
+// The statistics page that scee shares with each process it spawns. scee
+// creates a page per process and passes it open as the file descriptor
+// SCEE_STATS_FD, which it advertises in the environment variable
+// SCEE_STATS_ENV of that process only. The process checks that the file is
+// such a page, maps it with scee_stats_open and
+// publishes its counters with scee_stats_update, and scee reads them
+// directly, without signalling the process.
+//
+// Processes that can't map the page can still report their counters: when
+// scee sends them SIGUSR1, they reply with scee_info_reply, which queues
+// the signal SCEE_INFO_SIGNAL to scee carrying the counters as its value.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SCEE_STATS_H
+#define SCEE_STATS_H
+
+// #include directives
+////////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <signal.h>
+#include <stdatomic.h>
+////////////////////////////////////////////////////////////////////////////////
+
+// #define directives
+////////////////////////////////////////////////////////////////////////////////
+#define SCEE_STATS_FD 3
+#define SCEE_STATS_ENV "SCEE_STATS_FD"
+#define SCEE_STATS_CREATED 0x45454353u
+        // "SCEE", stored by scee when it creates the page.
+#define SCEE_STATS_MAGIC 0x65656373u
+        // "scee", stored once the page has been initialized by the process.
+#define SCEE_STATS_SIZE 4096
+#define SCEE_STATS_NAME_LENGTH 15
+
+#define SCEE_INFO_SIGNAL (SIGRTMIN + 1)
+        // Real-time signals are queued along with their value, unlike
+        // the standard ones, so no reply is lost.
+#define SCEE_INFO_DELAY_BITS 8
+#define SCEE_INFO_ENCODE(counter, delay) \
+        ((int)(((counter) << SCEE_INFO_DELAY_BITS) | \
+        ((delay) & ((1 << SCEE_INFO_DELAY_BITS) - 1))))
+#define SCEE_INFO_COUNTER(value) ((value) >> SCEE_INFO_DELAY_BITS)
+#define SCEE_INFO_DELAY(value) ((value) & ((1 << SCEE_INFO_DELAY_BITS) - 1))
+        // The counter and the delay are packed in the int value of the reply.
+////////////////////////////////////////////////////////////////////////////////
+
+// custom data types
+////////////////////////////////////////////////////////////////////////////////
+struct scee_stats_s {
+    // This struct is the layout of the statistics page. The process writes it
+    // under the seqlock sequence, and scee retries its reads while
+    // the sequence is odd or changes.
+    atomic_uint magic;  // SCEE_STATS_MAGIC once initialized,
+            // SCEE_STATS_CREATED before.
+    atomic_uint sequence;  // Odd while the counters are being updated.
+    int pid;  // The PID of the process.
+    char name[SCEE_STATS_NAME_LENGTH + 1];  // The name of the program.
+    long counter;  // The number of outputs so far.
+    long delay;  // The number of seconds between successive outputs.
+    long update_time;  // The time of the last update, CLOCK_MONOTONIC in ns.
+};
+typedef struct scee_stats_s scee_stats_t;
+////////////////////////////////////////////////////////////////////////////////
+
+// function prototypes
+////////////////////////////////////////////////////////////////////////////////
+scee_stats_t *scee_stats_open(const char *name);
+void scee_stats_update(scee_stats_t *stats, long counter, long delay);
+int scee_info_reply(const siginfo_t *info, long counter, long delay);
+size_t scee_format_long(char *buffer, long value);
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
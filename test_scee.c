@@ -0,0 +1,1801 @@
+// file test_scee.c
+////////////////////////////////////////////////////////////////////////////////
+// Description
+// This program runs the unit tests of the scee functions and, given the option
+// --bench, microbenchmarks of str_split, list_add, list_remove, list_search,
+// and command parsing. A failed check prints its file, line, and condition.
+//
+// The tests run by default and the program exits with a non-zero status if any
+// of them fails.
+////////////////////////////////////////////////////////////////////////////////
+
+// #include directives
+////////////////////////////////////////////////////////////////////////////////
+// scee.c is compiled into this program without its main function, so that the
+// tests can use its functions and global variables directly.
+#define SCEE_NO_MAIN
+#include "scee.c"
+#include <limits.h>
+////////////////////////////////////////////////////////////////////////////////
+
+// #define directives
+////////////////////////////////////////////////////////////////////////////////
+// Mark the current test as failed, printing where and why.
+#define FAIL_IF(condition) \
+    do { \
+        if (condition) { \
+            printf("\tcheck failed, %s:%d: %s\n", __FILE__, __LINE__, \
+                    #condition); \
+            failed = 1; \
+        } \
+    } while (0)
+#define FAIL() FAIL_IF(1)
+
+#define BENCH_MIN_OPERATIONS 1000000  // operations timed per list size
+////////////////////////////////////////////////////////////////////////////////
+
+// function prototypes
+////////////////////////////////////////////////////////////////////////////////
+int test_str_split();
+int test_path_intern();
+int test_capture_tail();
+int test_histogram();
+int test_cpuset();
+int test_list_create();
+int test_list_add();
+int test_list_remove();
+int output_capture(int *saved_fd);
+char *output_collect(int memory_fd, int saved_fd);
+int test_list_print();
+int test_list_search();
+int test_process_list();
+int test_all();
+int bench_str_split();
+int bench_list_add_remove();
+int bench_list_search();
+int bench_command_parsing();
+int bench_histogram();
+int bench_all();
+////////////////////////////////////////////////////////////////////////////////
+
+// functions
+////////////////////////////////////////////////////////////////////////////////
+int test_str_split() {
+    // Description
+    // This function tests the str_split function.
+    //
+    // Returns
+    // test_str_split returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    char *string;
+    char **tokens;
+    char *delimiters;
+    char **expected_tokens;
+    const char space[] = " ";
+    //const char tab[] = "\t";  // not used yet
+    const char space_tab[] = " \t";
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+    void *return_pointer;  // pointer placeholder for error checking
+    int i;  // generic counter
+
+    printf("testing str_split\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    return_pointer = strdup("a");
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        string = return_pointer;
+    }
+
+    return_pointer = strdup(space_tab);
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        delimiters = return_pointer;
+    }
+
+    expected_tokens = NULL;
+    return_pointer = (char **)realloc(expected_tokens,
+            (size_t)(1 * sizeof(*expected_tokens)));
+    if (return_pointer == NULL) {
+        perror("error, realloc");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        expected_tokens = return_pointer;
+    }
+
+    expected_tokens[0] = NULL;
+    return_pointer = strdup("a");
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        expected_tokens[0] = return_pointer;
+    }
+
+    tokens = NULL;
+    return_value = str_split(string, &tokens, delimiters);
+    FAIL_IF(return_value != 1);
+    if (return_value == 1) {
+        for (i = 0; i < 1; i++) {
+            FAIL_IF(strcmp(tokens[i], expected_tokens[i]));
+        }
+        FAIL_IF(tokens[1] != NULL);
+    }
+    if (!failed) {
+        num_passed++;
+    }
+    // TODO_PRIME free memory
+
+    // test 02
+    num_tests++;
+    failed = 0;
+
+    return_pointer = strdup("a b c");
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        string = return_pointer;
+    }
+
+    return_pointer = strdup(space);
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        delimiters = return_pointer;
+    }
+
+    expected_tokens = NULL;
+    return_pointer = (char **)realloc(expected_tokens,
+            (size_t)(3 * sizeof(*expected_tokens)));
+    if (return_pointer == NULL) {
+        perror("error, realloc");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        expected_tokens = return_pointer;
+    }
+
+    expected_tokens[0] = NULL;
+    return_pointer = strdup("a");
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        expected_tokens[0] = return_pointer;
+    }
+
+    expected_tokens[1] = NULL;
+    return_pointer = strdup("b");
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        expected_tokens[1] = return_pointer;
+    }
+
+    expected_tokens[2] = NULL;
+    return_pointer = strdup("c");
+    if (return_pointer == NULL) {
+        perror("error, strdup");
+        // TODO_PRIME free memory
+        return -1;
+    } else {
+        expected_tokens[2] = return_pointer;
+    }
+
+    tokens = NULL;
+    return_value = str_split(string, &tokens, delimiters);
+    FAIL_IF(return_value != 3);
+    if (return_value == 3) {
+        for (i = 0; i < 3; i++) {
+            FAIL_IF(strcmp(tokens[i], expected_tokens[i]));
+        }
+        FAIL_IF(tokens[3] != NULL);
+    }
+    if (!failed) {
+        num_passed++;
+    }
+    // TODO_PRIME free memory
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_path_intern() {
+    // Description
+    // This function tests the path_intern and path_release functions.
+    //
+    // Returns
+    // test_path_intern returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    char *first;
+    char *second;
+    char *other;
+    long initial_bytes;
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+
+    printf("testing path_intern\n");
+
+    num_tests = 0;
+    num_passed = 0;
+    initial_bytes = path_bytes;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    first = path_intern("./program");
+    second = path_intern("./program");
+    other = path_intern("./program_prime");
+    FAIL_IF((first == NULL) || (second != first) || (other == first) ||
+            strcmp(first, "./program") || strcmp(other, "./program_prime"));
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    num_tests++;
+    failed = 0;
+
+    path_release(second);
+    second = path_intern("./program");
+    FAIL_IF(second != first);
+    path_release(first);
+    path_release(second);
+    path_release(other);
+    FAIL_IF(path_bytes != initial_bytes);
+    if (!failed) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_capture_tail() {
+    // Description
+    // This function tests the capture_append and capture_tail functions.
+    //
+    // Returns
+    // test_capture_tail returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    capture_t *capture;
+    buffer_t buffer = { NULL, 0, 0 };
+    char line[32];
+    int length;
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int i;  // generic counter
+
+    printf("testing capture_tail\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    capture = (capture_t *)malloc(sizeof(capture_t) + CAPTURE_BUFFER_SIZE);
+    if (capture == NULL) {
+        perror("error, malloc");
+        return -1;
+    }
+    capture->capturing = 1;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    capture->num_written = 0;
+    capture_append(capture, "one\ntwo\nthree", 13);
+    length = capture_tail(capture, 2, &buffer);
+    FAIL_IF((length != 10) || strncmp(buffer.data, "two\nthree\n", 10));
+    buffer.length = 0;
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    num_tests++;
+    failed = 0;
+
+    // Wrap around the ring buffer many times.
+    capture->num_written = 0;
+    for (i = 0; i < 10000; i++) {
+        length = snprintf(line, sizeof(line), "line %d\n", i);
+        capture_append(capture, line, (size_t)length);
+    }
+    length = capture_tail(capture, 3, &buffer);
+    FAIL_IF((length != 30) ||
+            strncmp(buffer.data, "line 9997\nline 9998\nline 9999\n", 30));
+    buffer.length = 0;
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 03
+    num_tests++;
+    failed = 0;
+
+    // Only the last CAPTURE_BUFFER_SIZE bytes of a large write are kept.
+    capture->num_written = 0;
+    length = capture_tail(capture, 1, &buffer);
+    FAIL_IF(length != 0);
+    for (i = 0; i < CAPTURE_BUFFER_SIZE * 2; i++) {
+        line[0] = 'a' + (i % 26);
+        capture_append(capture, line, 1);
+    }
+    length = capture_tail(capture, 1, &buffer);
+    FAIL_IF((length != CAPTURE_BUFFER_SIZE + 1) ||
+            (buffer.data[0] != 'a' + (CAPTURE_BUFFER_SIZE % 26)) ||
+            (buffer.data[CAPTURE_BUFFER_SIZE] != '\n'));
+    buffer.length = 0;
+    if (!failed) {
+        num_passed++;
+    }
+
+    free(buffer.data);
+    free(capture);
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_histogram() {
+    // Description
+    // This function tests the histogram_index, histogram_bucket_limit,
+    // histogram_record, and histogram_percentile functions.
+    //
+    // Returns
+    // test_histogram returns 0 on successful completion of all tests or -1 in
+    // case of any test or itself failing.
+
+    // variable declaration
+    static histogram_t histogram;
+    long value;
+    long limit;
+    int index;
+    int previous_index;
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    long i;  // generic counter
+
+    printf("testing histogram\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    // Every value lies in a bucket whose limit isn't smaller than it and is
+    // within 1/16 of it, and the buckets increase with the values.
+    num_tests++;
+    failed = 0;
+
+    previous_index = 0;
+    for (i = 0; i < 64 * 4 + 63; i++) {
+        value = (i < 64 * 4) ? i : (1L << (i - 64 * 4)) + i % 7;
+        index = histogram_index(value);
+        limit = histogram_bucket_limit(index);
+        FAIL_IF((index < 0) || (index >= HISTOGRAM_BUCKETS));
+        FAIL_IF((limit < value) || (limit - value > value / 16));
+        FAIL_IF((i < 64 * 4) && (index < previous_index));
+        previous_index = index;
+        if (failed) {
+            printf("\tvalue %ld, bucket %d, limit %ld\n", value, index, limit);
+            break;
+        }
+    }
+    FAIL_IF(histogram_index(-5) != 0);
+    FAIL_IF(histogram_index(LONG_MAX) != HISTOGRAM_BUCKETS - 1);
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    // The percentiles of 1 to 1,000,000 are within 1/16 of the exact ones.
+    num_tests++;
+    failed = 0;
+
+    FAIL_IF(histogram_percentile(&histogram, 50.0) != 0);
+    for (i = 1; i <= 1000000; i++) {
+        histogram_record(&histogram, i);
+    }
+    value = histogram_percentile(&histogram, 50.0);
+    FAIL_IF((value < 500000) || (value > 500000 + 500000 / 16));
+    value = histogram_percentile(&histogram, 99.0);
+    FAIL_IF((value < 990000) || (value > 990000 + 990000 / 16));
+    FAIL_IF(histogram_percentile(&histogram, 100.0) != 1000000);
+    FAIL_IF((histogram.count != 1000000) || (histogram.max != 1000000));
+    if (!failed) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_cpuset() {
+    // Description
+    // This function tests the cpuset_parse, cpuset_format, and
+    // placement_choose functions.
+    //
+    // Returns
+    // test_cpuset returns 0 on successful completion of all tests or -1 in
+    // case of any test or itself failing.
+
+    // variable declaration
+    const char *invalid[] = { "", "x", "3-1", "1,,2", "1-", "2;3", "-1" };
+    exec_options_t options;
+    cpu_set_t set;
+    cpu_set_t seen;
+    unsigned long nodemask;
+    char string[64];
+    char description[MAX_PLACEMENT_LENGTH + 1];
+    int num_cpus;
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int i;  // generic counter
+
+    printf("testing cpuset\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    // A list of CPUs is parsed and formatted back the same, and invalid ones
+    // are rejected.
+    num_tests++;
+    failed = 0;
+
+    FAIL_IF(cpuset_parse("0-3,8,10-11", &set) != 0);
+    FAIL_IF(CPU_COUNT(&set) != 7);
+    FAIL_IF(!CPU_ISSET(8, &set) || CPU_ISSET(9, &set));
+    cpuset_format(&set, string, sizeof(string));
+    FAIL_IF(strcmp(string, "0-3,8,10-11"));
+    FAIL_IF(cpuset_parse("5\n", &set) != 0);
+    cpuset_format(&set, string, sizeof(string));
+    FAIL_IF(strcmp(string, "5"));
+    for (i = 0; i < (int)(sizeof(invalid) / sizeof(invalid[0])); i++) {
+        FAIL_IF(cpuset_parse(invalid[i], &set) != -1);
+    }
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    // Spreading over the CPUs places as many processes as there are CPUs on
+    // each of them once.
+    num_tests++;
+    failed = 0;
+
+    memset(&options, 0, sizeof(options));
+    options.spread = SPREAD_CPU;
+    FAIL_IF(placement_choose(&options, &set, &nodemask, description) != 0);
+    num_cpus = CPU_COUNT(&topology.cpus);
+    CPU_ZERO(&seen);
+    for (i = 0; i < num_cpus; i++) {
+        FAIL_IF(placement_choose(&options, &set, &nodemask, description) != 0);
+        FAIL_IF(CPU_COUNT(&set) != 1);
+        FAIL_IF(strncmp(description, "cpu ", 4));
+        CPU_OR(&seen, &seen, &set);
+    }
+    FAIL_IF(!CPU_EQUAL(&seen, &topology.cpus));
+    FAIL_IF(nodemask != 0);
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 03
+    // CPUs scee can't run on are never chosen.
+    num_tests++;
+    failed = 0;
+
+    options.spread = SPREAD_NONE;
+    options.has_cpus = 1;
+    CPU_ZERO(&options.cpus);
+    CPU_SET(CPU_SETSIZE - 1, &options.cpus);
+    FAIL_IF(!CPU_ISSET(CPU_SETSIZE - 1, &topology.cpus) &&
+            (placement_choose(&options, &set, &nodemask, description) != -1));
+    if (!failed) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_list_create() {
+    // Description
+    // This function tests the list_create function.
+    //
+    // Returns
+    // test_list_create returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    process_t *list;
+    process_t expected_list;
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+
+    printf("testing list_create\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    // expected_list initialization.
+    expected_list.pid = 0;
+    expected_list.path = NULL;
+    expected_list.stopped = 0;
+    expected_list.next = NULL;
+    expected_list.previous = NULL;
+
+    list = NULL;
+    return_value = list_create(&list);
+    if (return_value != -1) {
+        FAIL_IF((list == NULL) ||
+                (list->pid != expected_list.pid) ||
+                (list->path != expected_list.path) ||
+                (list->stopped != expected_list.stopped) ||
+                (list->next != list) ||
+                (list->previous != list) ||
+                (list->index == NULL) ||
+                (list->index->count != 0) ||
+                (list->index->length != 0));
+        if (!failed) {
+            num_passed++;
+        }
+    }
+    // TODO_PRIME free memory
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_list_add() {
+    // Description
+    // This function tests the list_add function.
+    //
+    // Returns
+    // test_list_add returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    process_t *list;
+    process_t *result;
+    int pid;
+    char path[MAX_PATH_LENGTH + 1];
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+
+    printf("testing list_add\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    list = NULL;
+    return_value = list_create(&list);
+    if (return_value == -1) {
+        printf("error, list_create\n");
+        return -1;
+    }
+
+    pid = 1;
+    strcpy(path, "./program");
+    return_value = list_add(list, pid, path);
+    if (return_value != -1) {
+        FAIL_IF((list->next->pid != pid) ||
+                (strcmp(list->next->path, path)) ||
+                (list->next->stopped != 0) ||
+                (list->next->next != list) ||
+                (list->next->previous != list));
+        FAIL_IF((list->previous->pid != pid) ||
+                (strcmp(list->previous->path, path)) ||
+                (list->previous->stopped != 0) ||
+                (list->previous->next != list) ||
+                (list->previous->previous != list));
+        if (!failed) {
+            num_passed++;
+        }
+    }
+    // TODO_PRIME free memory
+
+    // test 02
+    // A reaped process whose PID is reused is replaced in the index, while
+    // both nodes are counted in the length of the list.
+    num_tests++;
+    failed = 0;
+
+    list->next->exited = 1;
+    return_value = list_add(list, pid, path);
+    FAIL_IF(return_value == -1);
+    if (return_value != -1) {
+        FAIL_IF((list_search(list, &result, pid) != 1) ||
+                (result != list->next) || result->exited);
+        FAIL_IF((list->index->count != 1) || (list->index->length != 2));
+        list_remove(list->next->next);
+        FAIL_IF((list_search(list, &result, pid) != 1) ||
+                (result != list->next) || (list->next->next != list));
+        FAIL_IF((list->index->count != 1) || (list->index->length != 1));
+    }
+    list->next->exited = 0;
+    FAIL_IF(list_add(list, pid, path) != -1);
+    if (!failed) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_list_remove() {
+    // Description
+    // This function tests the list_remove function.
+    //
+    // Returns
+    // test_list_remove returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    process_t *list;
+    process_t *result;
+    process_t *second;  // the second node of the list
+    process_t *third;  // the third node of the list
+    int pid;
+    char path[MAX_PATH_LENGTH + 1];
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+
+    printf("testing list_remove\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    list = NULL;
+    return_value = list_create(&list);
+    if (return_value == -1) {
+        printf("error, list_create\n");
+        return -1;
+    }
+
+    pid = 1;
+    strcpy(path, "./program");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 10;
+    strcpy(path, "./program_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 100;
+    strcpy(path, "./program_double_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 1000;
+    strcpy(path, "./program_triple_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    // The list is 1000, 100, 10, 1, since list_add adds after the sentinel.
+    second = list->next->next;
+    third = second->next;
+
+    // test 01
+    // The last node.
+    num_tests++;
+    failed = 0;
+
+    pid = 1;
+    return_value = list_search(list, &result, pid);
+    if (return_value == -1) {
+        printf("error, list_search\n");
+    }
+    return_value = list_remove(result);
+    if (return_value != -1) {
+        return_value = list_search(list, &result, pid);
+        if (return_value == -1) {
+            printf("error, list_search\n");
+        }
+        FAIL_IF(return_value != 0);
+        FAIL_IF((list->previous != third) || (third->next != list));
+        FAIL_IF((list->index->length != 3) || (list->index->count != 3));
+    } else {
+        FAIL();
+    }
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    // A node in the middle.
+    num_tests++;
+    failed = 0;
+
+    return_value = list_remove(second);
+    if (return_value != -1) {
+        FAIL_IF(list_search(list, &result, 100) != 0);
+        FAIL_IF((list->next->next != third) ||
+                (third->previous != list->next) ||
+                (list->next->pid != 1000) || (third->pid != 10));
+        FAIL_IF((list->index->length != 2) || (list->index->count != 2));
+    } else {
+        FAIL();
+    }
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 03
+    // The remaining nodes, which leaves the sentinel alone.
+    num_tests++;
+    failed = 0;
+
+    FAIL_IF((list_remove(list->next) == -1) ||
+            (list_remove(list->next) == -1));
+    FAIL_IF((list->next != list) || (list->previous != list));
+    FAIL_IF((list->index->length != 0) || (list->index->count != 0));
+    if (!failed) {
+        num_passed++;
+    }
+
+    // TODO_PRIME free memory
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int output_capture(int *saved_fd) {
+    // Description
+    // This function redirects the standard output to a memory file, so that
+    // a test can check what a function prints. The original standard output
+    // is stored in saved_fd, for output_collect to restore.
+    //
+    // Returns
+    // output_capture returns the memory file or -1 in case of failure.
+
+    // variable declaration
+    int memory_fd;
+
+    fflush(stdout);
+    *saved_fd = dup(STDOUT_FILENO);
+    if (*saved_fd == -1) {
+        perror("error, dup");
+        return -1;
+    }
+
+    memory_fd = memfd_create("test-output", MFD_CLOEXEC);
+    if (memory_fd == -1) {
+        perror("error, memfd_create");
+        close(*saved_fd);
+        return -1;
+    }
+    dup2(memory_fd, STDOUT_FILENO);
+
+    return memory_fd;
+}
+
+char *output_collect(int memory_fd, int saved_fd) {
+    // Description
+    // This function restores the standard output saved_fd saved by
+    // output_capture, and reads what was printed in the memory file
+    // memory_fd meanwhile, closing both.
+    //
+    // Returns
+    // output_collect returns the output as a null-terminated string, to be
+    // freed by the caller, or NULL in case of failure.
+
+    // variable declaration
+    char *output;
+    off_t length;
+    ssize_t num_read;
+
+    fflush(stdout);
+    dup2(saved_fd, STDOUT_FILENO);
+    close(saved_fd);
+
+    output = NULL;
+    length = lseek(memory_fd, 0, SEEK_END);
+    if (length != -1) {
+        output = (char *)malloc((size_t)length + 1);
+    }
+    if (output != NULL) {
+        num_read = pread(memory_fd, output, (size_t)length, 0);
+        if (num_read != (ssize_t)length) {
+            free(output);
+            output = NULL;
+        } else {
+            output[length] = '\0';
+        }
+    }
+    close(memory_fd);
+
+    return output;
+}
+
+int test_list_print() {
+    // Description
+    // This function tests the list_print function.
+    //
+    // Returns
+    // test_list_print returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    process_t *list;
+    process_t *node;
+    int pid;
+    char path[MAX_PATH_LENGTH + 1];
+    char *output;  // what list_print printed
+    buffer_t expected = { NULL, 0, 0 };  // what it should have printed
+    const char first_node[] = "node: 1\n\tpid: 1000\n"
+            "\tpath: ./program_triple_prime\n";
+    int memory_fd;  // the memory file the output goes to
+    int saved_fd;  // the original standard output
+    int i;  // generic counter
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+
+    printf("testing list_print\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    list = NULL;
+    return_value = list_create(&list);
+    if (return_value == -1) {
+        printf("error, list_create\n");
+        return -1;
+    }
+
+    pid = 1;
+    strcpy(path, "./program");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 10;
+    strcpy(path, "./program_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 100;
+    strcpy(path, "./program_double_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 1000;
+    strcpy(path, "./program_triple_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    // Every node is printed, from the most recently added one.
+    memory_fd = output_capture(&saved_fd);
+    if (memory_fd == -1) {
+        printf("error, output_capture\n");
+        return -1;
+    }
+    return_value = list_print(list);
+    output = output_collect(memory_fd, saved_fd);
+    FAIL_IF(return_value == -1);
+    FAIL_IF(output == NULL);
+
+    i = 0;
+    for (node = list->next; node != list; node = node->next) {
+        i++;
+        buffer_printf(&expected, "node: %d\n\tpid: %d\n\tpath: %s\n"
+                "\tstopped: 0\n\tnext: %p\n\tprevious: %p\n", i, node->pid,
+                node->path, node->next, node->previous);
+    }
+    FAIL_IF(i != 4);
+    FAIL_IF((output == NULL) ||
+            strncmp(output, first_node, sizeof(first_node) - 1));
+    FAIL_IF((output != NULL) && (expected.data != NULL) &&
+            strcmp(output, expected.data));
+    free(expected.data);
+    free(output);
+    // TODO_PRIME free memory
+
+    if (!failed) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_list_search() {
+    // Description
+    // This function tests the list_search function.
+    //
+    // Returns
+    // test_list_search returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    process_t *list;
+    process_t *result;
+    int pid;
+    char path[MAX_PATH_LENGTH + 1];
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+
+    printf("testing list_search\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    list = NULL;
+    return_value = list_create(&list);
+    if (return_value == -1) {
+        printf("error, list_create\n");
+        return -1;
+    }
+
+    pid = 1;
+    strcpy(path, "./program");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 10;
+    strcpy(path, "./program_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 100;
+    strcpy(path, "./program_double_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 1000;
+    strcpy(path, "./program_triple_prime");
+    return_value = list_add(list, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    pid = 1;
+    return_value = list_search(list, &result, pid);
+    FAIL_IF((return_value != 1) || (result == NULL) || (result->pid != pid));
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    num_tests++;
+    failed = 0;
+
+    pid = 100;
+    return_value = list_search(list, &result, pid);
+    FAIL_IF((return_value != 1) || (result == NULL) || (result->pid != pid));
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 03
+    num_tests++;
+    failed = 0;
+
+    pid = 4;
+    return_value = list_search(list, &result, pid);
+    FAIL_IF((return_value != 0) || (result != NULL));
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 04
+    num_tests++;
+    failed = 0;
+
+    pid = 111;
+    return_value = list_search(list, &result, pid);
+    FAIL_IF((return_value != 0) || (result != NULL));
+    if (!failed) {
+        num_passed++;
+    }
+
+    // TODO_PRIME free memory
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_process_list() {
+    // Description
+    // This function tests the process_list function.
+    //
+    // Returns
+    // test_process_list returns 0 on successful completion of all tests or
+    // -1 in case of any test or itself failing.
+
+    // variable declaration
+    process_t *processes;
+    char *no_arguments[] = { NULL };
+    char *limit_arguments[] = { "--limit", "1", NULL };
+    int pid;
+    char path[MAX_PATH_LENGTH + 1];
+    char *output;  // what process_list printed
+    char *row;  // a row of the table in output
+    int memory_fd;  // the memory file the output goes to
+    int saved_fd;  // the original standard output
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int failed;  // boolean indicator that a test failed
+    int return_value;  // integer placeholder for error checking
+
+    printf("testing process_list\n");
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test 01
+    num_tests++;
+    failed = 0;
+
+    // Create the processes list.
+    processes = NULL;
+    return_value = list_create(&processes);
+    if (return_value == -1) {
+        printf("error, list_create\n");
+        return -1;
+    }
+
+    pid = 1;
+    strcpy(path, "./program");
+    return_value = list_add(processes, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    pid = 1000;
+    strcpy(path, "./program_prime");
+    return_value = list_add(processes, pid, path);
+    if (return_value == -1) {
+        printf("error, list_add\n");
+    }
+
+    // Both rows are printed, the most recently added first, followed by
+    // the memory statistics.
+    memory_fd = output_capture(&saved_fd);
+    if (memory_fd == -1) {
+        printf("error, output_capture\n");
+        return -1;
+    }
+    return_value = process_list(processes, no_arguments);
+    output = output_collect(memory_fd, saved_fd);
+    FAIL_IF(return_value == -1);
+    FAIL_IF(output == NULL);
+    if (output != NULL) {
+        row = strstr(output, "|  1000 |  running | ./program_prime \n");
+        FAIL_IF(row == NULL);
+        FAIL_IF((row != NULL) &&
+                (strstr(row, "|     1 |  running | ./program \n") == NULL));
+        FAIL_IF(strstr(output, "entries shown") != NULL);
+        FAIL_IF(strstr(output, "\n2 processes tracked, ") == NULL);
+        FAIL_IF(strstr(output, "\nnode pool: ") == NULL);
+    }
+    free(output);
+
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 02
+    // A page of the table, without the row of the exited process, which is
+    // kept until it is shown.
+    num_tests++;
+    failed = 0;
+
+    processes->previous->exited = 1;
+    processes->previous->exit_status = 3 << 8;
+    memory_fd = output_capture(&saved_fd);
+    if (memory_fd == -1) {
+        printf("error, output_capture\n");
+        return -1;
+    }
+    return_value = process_list(processes, limit_arguments);
+    output = output_collect(memory_fd, saved_fd);
+    FAIL_IF(return_value == -1);
+    FAIL_IF(output == NULL);
+    if (output != NULL) {
+        FAIL_IF(strstr(output, "|  1000 |  running | ./program_prime \n") ==
+                NULL);
+        FAIL_IF(strstr(output, "./program \n") != NULL);
+        FAIL_IF(strstr(output, "\n1 of 2 entries shown\n") == NULL);
+        FAIL_IF(strstr(output, "removed") != NULL);
+    }
+    free(output);
+    FAIL_IF(processes->index->length != 2);
+
+    if (!failed) {
+        num_passed++;
+    }
+
+    // test 03
+    // The exited process is shown with its exit status, then removed.
+    num_tests++;
+    failed = 0;
+
+    memory_fd = output_capture(&saved_fd);
+    if (memory_fd == -1) {
+        printf("error, output_capture\n");
+        return -1;
+    }
+    return_value = process_list(processes, no_arguments);
+    output = output_collect(memory_fd, saved_fd);
+    FAIL_IF(return_value == -1);
+    FAIL_IF(output == NULL);
+    if (output != NULL) {
+        FAIL_IF(strstr(output, "|     1 |  exit 3  | ./program \n") == NULL);
+        FAIL_IF(strstr(output, "\n1 exited process entry was removed\n") ==
+                NULL);
+        FAIL_IF(strstr(output, "\n1 processes tracked, ") == NULL);
+    }
+    free(output);
+    FAIL_IF((processes->index->length != 1) ||
+            (processes->next->pid != 1000) ||
+            (processes->next->next != processes));
+    // TODO_PRIME free memory
+
+    if (!failed) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\tall tests passed\n");
+        return 0;
+    } else {
+        printf("\tat least one test failed\n");
+        return -1;
+    }
+}
+
+int test_all() {
+    // Description
+    // This function calls all the test functions of this program.
+    //
+    // Returns
+    // test_all returns 0 on successful completion of all test functions or
+    // -1 in case of any test function or itself failing.
+
+    // variable declaration
+    int num_tests;  // number of tests
+    int num_passed;  // number of tests passed
+    int return_value;  // integer placeholder for error checking
+
+    num_tests = 0;
+    num_passed = 0;
+
+    // test_str_split
+    num_tests++;
+    return_value = test_str_split();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_path_intern
+    num_tests++;
+    return_value = test_path_intern();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_capture_tail
+    num_tests++;
+    return_value = test_capture_tail();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_histogram
+    num_tests++;
+    return_value = test_histogram();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_cpuset
+    num_tests++;
+    return_value = test_cpuset();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_list_create
+    num_tests++;
+    return_value = test_list_create();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_list_add
+    num_tests++;
+    return_value = test_list_add();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_list_remove
+    num_tests++;
+    return_value = test_list_remove();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_list_print
+    num_tests++;
+    return_value = test_list_print();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_list_search
+    num_tests++;
+    return_value = test_list_search();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    // test_process_list
+    num_tests++;
+    return_value = test_process_list();
+    if (return_value == 0) {
+        num_passed++;
+    }
+
+    if (num_passed == num_tests) {
+        printf("\n");
+        printf("all tests passed\n");
+        return 0;
+    } else {
+        printf("\n");
+        printf("at least one test failed\n");
+        return -1;
+    }
+}
+
+int bench_str_split() {
+    // Description
+    // This function measures the mean latency of str_split, including freeing
+    // the tokens, on commands of 2, 8, and 32 tokens.
+    //
+    // Returns
+    // bench_str_split returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    const int sizes[] = { 2, 8, 32 };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int num_splits = 200000;
+    char string[32 * 8 + 1];
+    char **tokens;
+    struct timespec start;
+    int num_tokens;  // defeats the elimination of the splits
+    int return_value;  // integer placeholder for error checking
+    int i, j, k;  // generic counters
+
+    printf("benchmarking str_split\n");
+    printf("\t%8s  %14s\n", "tokens", "latency (ns)");
+
+    for (i = 0; i < num_sizes; i++) {
+        // Tokens of up to six characters separated by spaces and tabs.
+        string[0] = '\0';
+        for (j = 0; j < sizes[i]; j++) {
+            strcat(string, (j & 1) ? "\t12345" : " exec");
+        }
+
+        num_tokens = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (j = 0; j < num_splits; j++) {
+            tokens = NULL;
+            return_value = str_split(string, &tokens, " \t");
+            if (return_value == -1) {
+                printf("error, str_split\n");
+                return -1;
+            }
+            for (k = 0; tokens[k] != NULL; k++) {
+                free(tokens[k]);
+            }
+            free(tokens);
+            num_tokens += k;
+        }
+        printf("\t%8d  %14.1f\n", num_tokens / num_splits,
+                (double)elapsed_nanoseconds(&start) / num_splits);
+    }
+
+    return 0;
+}
+
+int bench_list_add_remove() {
+    // Description
+    // This function measures the mean latency of list_add and list_remove on
+    // lists growing to and shrinking from 10, 1,000, and 100,000 entries. Small
+    // lists are filled and emptied repeatedly, so that at least
+    // BENCH_MIN_OPERATIONS of each are timed.
+    //
+    // Returns
+    // bench_list_add_remove returns 0 on successful completion or -1 in case
+    // of failure.
+
+    // variable declaration
+    const int sizes[] = { 10, 1000, 100000 };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    process_t *list;
+    struct timespec start;
+    long add_ns;  // total time spent in list_add in nanoseconds
+    long remove_ns;  // total time spent in list_remove in nanoseconds
+    int num_rounds;
+    int return_value;  // integer placeholder for error checking
+    int i, j, k;  // generic counters
+
+    printf("benchmarking list_add and list_remove\n");
+    printf("\t%8s  %14s  %14s\n", "entries", "add (ns)", "remove (ns)");
+
+    for (i = 0; i < num_sizes; i++) {
+        list = NULL;
+        return_value = list_create(&list);
+        if (return_value == -1) {
+            printf("error, list_create\n");
+            return -1;
+        }
+
+        num_rounds = (BENCH_MIN_OPERATIONS + sizes[i] - 1) / sizes[i];
+        add_ns = 0;
+        remove_ns = 0;
+        for (j = 0; j < num_rounds; j++) {
+            // PIDs are spaced out like those of processes spawned over time.
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (k = 1; k <= sizes[i]; k++) {
+                return_value = list_add(list, 7 * k, "./program");
+                if (return_value == -1) {
+                    printf("error, list_add\n");
+                    return -1;
+                }
+            }
+            add_ns += elapsed_nanoseconds(&start);
+
+            // Processes are removed oldest first, as they usually terminate.
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            while (list->next != list) {
+                list_remove(list->next);
+            }
+            remove_ns += elapsed_nanoseconds(&start);
+        }
+
+        printf("\t%8d  %14.1f  %14.1f\n", sizes[i],
+                (double)add_ns / ((long)num_rounds * sizes[i]),
+                (double)remove_ns / ((long)num_rounds * sizes[i]));
+
+        // Memory deallocation.
+        index_delete(list->index);
+        free(list);
+    }
+
+    return 0;
+}
+
+int bench_list_search() {
+    // Description
+    // This function measures the mean latency of list_search on lists of
+    // 10, 1,000, and 100,000 entries, for hits and misses, and compares it to
+    // a linear scan of the same list.
+    //
+    // Returns
+    // bench_list_search returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    const int sizes[] = { 10, 1000, 100000 };
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int num_lookups = 1000000;
+    process_t *list;
+    process_t *result;
+    process_t *node;
+    struct timespec start;
+    struct timespec end;
+    double indexed_ns;  // mean latency of a list_search in nanoseconds
+    double linear_ns;  // mean latency of a linear scan in nanoseconds
+    int num_found;  // defeats the elimination of the lookups
+    int num_scans;
+    int pid;
+    int return_value;  // integer placeholder for error checking
+    int i, j;  // generic counters
+
+    printf("benchmarking list_search\n");
+    printf("\t%8s  %14s  %14s\n", "entries", "indexed (ns)", "linear (ns)");
+
+    for (i = 0; i < num_sizes; i++) {
+        list = NULL;
+        return_value = list_create(&list);
+        if (return_value == -1) {
+            printf("error, list_create\n");
+            return -1;
+        }
+
+        // PIDs are spaced out like those of processes spawned over time.
+        for (j = 1; j <= sizes[i]; j++) {
+            return_value = list_add(list, 7 * j, "./program");
+            if (return_value == -1) {
+                printf("error, list_add\n");
+                return -1;
+            }
+        }
+
+        // Half of the lookups are hits and half are misses.
+        num_found = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (j = 0; j < num_lookups; j++) {
+            pid = 7 * (j % sizes[i] + 1) + (j & 1);
+            num_found += list_search(list, &result, pid);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        indexed_ns = ((end.tv_sec - start.tv_sec) * 1e9 +
+                (end.tv_nsec - start.tv_nsec)) / num_lookups;
+
+        // The linear scan is limited to fewer lookups on large lists.
+        num_scans = num_lookups / sizes[i];
+        if (num_scans < 100) {
+            num_scans = 100;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (j = 0; j < num_scans; j++) {
+            pid = 7 * (j % sizes[i] + 1) + (j & 1);
+            for (node = list->next; node != list; node = node->next) {
+                if (node->pid == pid) {
+                    num_found++;
+                    break;
+                }
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        linear_ns = ((end.tv_sec - start.tv_sec) * 1e9 +
+                (end.tv_nsec - start.tv_nsec)) / num_scans;
+
+        printf("\t%8d  %14.1f  %14.1f\n", sizes[i], indexed_ns, linear_ns);
+
+        if (num_found == 0) {
+            printf("\tno entries found\n");
+        }
+
+        // Memory deallocation.
+        while (list->next != list) {
+            list_remove(list->next);
+        }
+        index_delete(list->index);
+        free(list);
+    }
+
+    return 0;
+}
+
+int bench_command_parsing() {
+    // Description
+    // This function measures the number of commands per second that can be
+    // read and parsed with read_command and task_search, and with
+    // the previous approach of getline, realloc, str_split, and a chain of
+    // strcmp calls. The commands are read from a memory stream.
+    //
+    // Returns
+    // bench_command_parsing returns 0 on successful completion or -1 in case
+    // of failure.
+
+    // variable declaration
+    const char *script_lines[] = { "stop 1234\n", "cont 1234\n", "list\n",
+            "exec ./integers 1\n", "info 1234\n", "k 1234\n" };
+    const int num_script_lines = sizeof(script_lines) / sizeof(script_lines[0]);
+    const int num_commands = 600000;
+    static command_t command;
+    char *script;
+    size_t script_length;
+    FILE *stream;
+    char *raw_input;
+    char **input;
+    size_t buffer_size;
+    struct timespec start;
+    struct timespec end;
+    double seconds;
+    int num_found;  // defeats the elimination of the parsing
+    int return_value;  // integer placeholder for error checking
+    int i, j;  // generic counters
+
+    printf("benchmarking command parsing\n");
+
+    // Build the script.
+    stream = open_memstream(&script, &script_length);
+    if (stream == NULL) {
+        perror("error, open_memstream");
+        return -1;
+    }
+    for (i = 0; i < num_commands; i++) {
+        fputs(script_lines[i % num_script_lines], stream);
+    }
+    fclose(stream);
+
+    // read_command and task_search
+    stream = fmemopen(script, script_length, "r");
+    if (stream == NULL) {
+        perror("error, fmemopen");
+        free(script);
+        return -1;
+    }
+    num_found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (read_command(stream, &command) != -1) {
+        if (task_search(command.tokens[0]) != NULL) {
+            num_found++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fclose(stream);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("\tread_command: %.0f commands per second\n", num_found / seconds);
+
+    // getline, realloc, str_split, and strcmp, as get_input and task_queue
+    // used to do.
+    stream = fmemopen(script, script_length, "r");
+    if (stream == NULL) {
+        perror("error, fmemopen");
+        free(script);
+        return -1;
+    }
+    num_found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (;;) {
+        raw_input = NULL;
+        buffer_size = 0;
+        return_value = getline(&raw_input, &buffer_size, stream);
+        if (return_value == -1) {
+            free(raw_input);
+            break;
+        }
+        raw_input[return_value - 1] = '\0';
+        raw_input = realloc(raw_input, (size_t)return_value);
+
+        input = NULL;
+        return_value = str_split(raw_input, &input, " \t");
+        if (return_value == -1) {
+            free(raw_input);
+            break;
+        }
+
+        if (!strcmp(input[0], "exec") || !strcmp(input[0], "e") ||
+                !strcmp(input[0], "kill") || !strcmp(input[0], "k") ||
+                !strcmp(input[0], "stop") || !strcmp(input[0], "s") ||
+                !strcmp(input[0], "cont") || !strcmp(input[0], "c") ||
+                !strcmp(input[0], "list") || !strcmp(input[0], "l") ||
+                !strcmp(input[0], "info") || !strcmp(input[0], "i")) {
+            num_found++;
+        }
+
+        free(raw_input);
+        for (j = 0; input[j] != NULL; j++) {
+            free(input[j]);
+        }
+        free(input);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fclose(stream);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("\tstr_split: %.0f commands per second\n", num_found / seconds);
+
+    free(script);
+
+    return 0;
+}
+
+int bench_histogram() {
+    // Description
+    // This function measures the mean cost of histogram_record, alone and
+    // together with the two reads of the monotonic clock that time an event.
+    //
+    // Returns
+    // bench_histogram returns 0 on successful completion or -1 in case of
+    // failure.
+
+    // variable declaration
+    const int num_records = 10000000;
+    static histogram_t histogram;
+    struct timespec start;
+    long begin;
+    int i;  // generic counter
+
+    printf("benchmarking histogram_record\n");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < num_records; i++) {
+        histogram_record(&histogram, (i * 2654435761L) & 0xfffff);
+    }
+    printf("\thistogram_record: %.1f ns\n",
+            (double)elapsed_nanoseconds(&start) / num_records);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < num_records; i++) {
+        begin = monotonic_nanoseconds();
+        histogram_record(&histogram, monotonic_nanoseconds() - begin);
+    }
+    printf("\ttimed event: %.1f ns\n",
+            (double)elapsed_nanoseconds(&start) / num_records);
+
+    if (histogram.count != 2L * num_records) {
+        printf("\tvalues lost\n");
+    }
+
+    return 0;
+}
+
+int bench_all() {
+    // Description
+    // This function calls all the microbenchmark functions of this program.
+    //
+    // Returns
+    // bench_all returns 0 on successful completion of all microbenchmark
+    // functions or -1 in case of any of them failing.
+
+    // variable declaration
+    int failed;  // boolean indicator that a microbenchmark failed
+
+    failed = 0;
+    failed |= (bench_str_split() == -1);
+    failed |= (bench_list_add_remove() == -1);
+    failed |= (bench_list_search() == -1);
+    failed |= (bench_command_parsing() == -1);
+    failed |= (bench_histogram() == -1);
+
+    return failed ? -1 : 0;
+}
+////////////////////////////////////////////////////////////////////////////////
+
+// main function
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[]) {
+    // Description
+    // The main function runs the unit tests or, given the option --bench,
+    // the microbenchmarks.
+    //
+    // Returns
+    // main returns 0 on successful completion or 1 in case of failure.
+
+    // variable declaration
+    int return_value;  // integer placeholder for error checking
+
+    if ((argc == 2) && !strcmp(argv[1], "--bench")) {
+        return_value = bench_all();
+    } else if (argc == 1) {
+        return_value = test_all();
+    } else {
+        printf("usage: %s [--bench]\n", argv[0]);
+        return 1;
+    }
+
+    return (return_value == -1) ? 1 : 0;
+}
+////////////////////////////////////////////////////////////////////////////////
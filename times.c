@@ -9,15 +9,23 @@
 // #include directives
 ////////////////////////////////////////////////////////////////////////////////
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <errno.h>
+#include "scee_stats.h"
 ////////////////////////////////////////////////////////////////////////////////
 
 // #define directives
 ////////////////////////////////////////////////////////////////////////////////
 #define PROGRAM_DESCRIPTION "A simple program that prints to stdout the current time 128 times, once every 4 seconds or the number of seconds passed as an argument. This value must be in the range [1, 32]."
+
+// The parts of the message printed on SIGUSR1 around the delay and counter.
+#define MESSAGE_DELAY "\n!!! times, delay "
+#define MESSAGE_COUNTER ": "
+#define MESSAGE_END " outputs so far, doing great !!!\n"
 ////////////////////////////////////////////////////////////////////////////////
 
 // custom data types
@@ -37,26 +45,45 @@ static volatile sig_atomic_t delay = 4;  // number of seconds to wait between
 
 // functions
 ////////////////////////////////////////////////////////////////////////////////
-static void handler_sigusr1(int signal_received) {
+static void handler_sigusr1(int signal_received, siginfo_t *info,
+        void *context) {
     // Description
-    // This function is the signal handler for SIGUSR1.
-    //
-    // NOTE
-    // I'd prefer to avoid using the non async-signal-safe function printf here,
-    // and use write multiple times instead, calculating the length of counter
-    // and delay values as strings with simple comparisons.
-    //
-    // NOTE
-    // Of course sending back a signal to the parent is a still superior
-    // implementation.
+    // This function is the signal handler for SIGUSR1. If the signal was sent
+    // by scee, the number of outputs and the delay are sent back to it with
+    // scee_info_reply, otherwise they are printed. Only async-signal-safe
+    // functions are used, so the output is formatted by hand and written with
+    // a single write.
     //
     // Returns
     // handler_sigusr1 does not return any value.
 
     // variable declaration
+    char message[128];
+    size_t length;
+    int saved_errno;  // errno of the interrupted code
+    int return_value;  // integer placeholder for error checking
+
+    (void)signal_received;
+    (void)context;
 
-    printf("\n!!! times, delay %d: %d outputs so far, doing great !!!\n",
-            delay, counter);
+    saved_errno = errno;
+
+    return_value = scee_info_reply(info, counter + 1, delay);
+    if (return_value == -1) {
+        length = 0;
+        memcpy(message + length, MESSAGE_DELAY, sizeof(MESSAGE_DELAY) - 1);
+        length += sizeof(MESSAGE_DELAY) - 1;
+        length += scee_format_long(message + length, delay);
+        memcpy(message + length, MESSAGE_COUNTER, sizeof(MESSAGE_COUNTER) - 1);
+        length += sizeof(MESSAGE_COUNTER) - 1;
+        length += scee_format_long(message + length, counter + 1);
+        memcpy(message + length, MESSAGE_END, sizeof(MESSAGE_END) - 1);
+        length += sizeof(MESSAGE_END) - 1;
+
+        return_value = (int)write(STDOUT_FILENO, message, length);
+    }
+
+    errno = saved_errno;
 }
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -75,18 +102,24 @@ int main(int argc, char *argv[]) {
     // main returns 0 on successful completion or -1 in case of failure.
 
     // variable declaration
-    struct sigaction action = { {0} };
+    struct sigaction action;
+    scee_stats_t *stats;  // the statistics page shared with scee, or NULL
     time_t system_time;
     struct tm *bd_time;  // broken down time
     int return_value;  // integer placeholder for error checking
 
-    action.sa_handler = handler_sigusr1;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = handler_sigusr1;
+    action.sa_flags = SA_SIGINFO;
     return_value = sigaction(SIGUSR1, &action, NULL);
     if (return_value == -1) {
         perror("error, sigaction");
         return -1;
     }
 
+    // Publish the statistics in the page shared with scee, if spawned by it.
+    stats = scee_stats_open("times");
+
     printf("\n%s\n", PROGRAM_DESCRIPTION);
 
     if (argc < 2) {
@@ -109,6 +142,7 @@ int main(int argc, char *argv[]) {
 
         printf("\n\ttimes, delay %d: %02d:%02d:%02d\n",
                 delay, bd_time->tm_hour, bd_time->tm_min, bd_time->tm_sec);
+        scee_stats_update(stats, counter + 1, delay);
         sleep(delay);
     }
 